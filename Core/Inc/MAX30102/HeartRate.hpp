@@ -11,32 +11,42 @@
 #include <stdint.h>
 #include "ox_data_structure.hpp"
 #include "algo_utils.hpp"
-#include "etl/standard_deviation.h"
+#include "profiler.hpp"
 
-class HeartRate {
+// Math        - algo::utils::float_math or fixed_math, see algo_utils.hpp for the difference
+// SAMPLE_RATE - sps the filters are designed for (filter_design.hpp)
+// BANDPASSED  - input comes through algo::filter::PpgBandpass (biquad.hpp), box smoothing is skipped
+template<typename Math = algo::utils::float_math, uint32_t SAMPLE_RATE = MAX30102_SAMPLES_PER_SECOND, bool BANDPASSED = false>
+class BasicHeartRate {
 public:
-	HeartRate() : _heart_rate{0} {
-		_smoothing_window.fill(1);
-	};
-	virtual ~HeartRate(){};
-
-	void process(OxStream& signal){
-		auto& ir = signal.get_ir();
-		algo::utils::convolution(_smoothing_window, ir);
-		algo::utils::gradient(ir, signal.get_time());
-
-		etl::standard_deviation<etl::standard_deviation_type::Population, int32_t> standard_deviation(ir.begin(), ir.end());
-		const int32_t std_dev = static_cast<int32_t>(standard_deviation.get_standard_deviation());
-		_heart_rate = algo::utils::hr_calculator(ir, signal.get_time(), std_dev);
+	BasicHeartRate() : _heart_rate{0} {};
+	virtual ~BasicHeartRate(){};
+
+	// BasicOxStream or OxWindow, IR channel is overwritten with its derivative
+	template<typename Window>
+	void process(Window& signal){
+		PROFILE_SCOPE(HeartRateProcess);
+		auto&& ir = signal.get_ir();
+		auto&& time = signal.get_time();
+		int32_t std_dev;
+		{
+			PROFILE_SCOPE(SmoothedGradient);
+			std_dev = algo::utils::smoothed_gradient<Math, Filter::GRADIENT_LAG>(_smoothing_window, ir, time);
+		}
+		PROFILE_SCOPE(HrCalculator);
+		_heart_rate = algo::utils::hr_calculator(Math{}, ir, time, std_dev, Filter::MIN_PEAK_SAMPLES);
 	};
 
 	uint32_t get_hr(void) {return _heart_rate;};
 
 private:
+	using Filter = algo::design::HrFilter<SAMPLE_RATE, BANDPASSED>;
 
 	uint32_t _heart_rate;
-	static size_t const constexpr SMOOTHING_SIZE = 20;
-	etl::array<int32_t, SMOOTHING_SIZE> _smoothing_window{};
+	algo::utils::box_window<int32_t, Filter::SMOOTHING_SIZE> _smoothing_window{};
 };
 
+using HeartRate = BasicHeartRate<>;
+using FixedHeartRate = BasicHeartRate<algo::utils::fixed_math>;
+
 #endif /* INC_MAX30102_HEARTRATE_H_ */
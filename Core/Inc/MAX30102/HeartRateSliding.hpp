@@ -0,0 +1,82 @@
+/*
+ * HeartRateSliding.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#ifndef INC_MAX30102_HEARTRATESLIDING_HPP_
+#define INC_MAX30102_HEARTRATESLIDING_HPP_
+
+#include <stdint.h>
+#include "ox_data_structure.hpp"
+#include "algo_utils.hpp"
+#include "filter_design.hpp"
+#include "hr_stages.hpp"
+#include "profiler.hpp"
+
+/*
+ * HeartRate pipeline over a sliding window - WINDOW_SIZE samples analysed every
+ * HOP_SIZE samples. Box smoothing and gradient run once per sample as it arrives
+ * and their results are kept for the whole window, std-dev comes from running
+ * sums, so a hop only adds HOP_SIZE samples of filtering and one peak scan
+ * (hr_calculator) over the kept gradients instead of reprocessing the window.
+ *
+ * Gradients lag the input by smoothing plus gradient span (forward filters),
+ * the window ends at the newest gradient. First HR once the window is full.
+ * SAMPLE_RATE - sps the filters are designed for (filter_design.hpp)
+ * Math        - algo::utils::float_math or fixed_math
+ * BANDPASSED  - input comes through algo::filter::PpgBandpass, box smoothing is skipped
+ */
+template<size_t WINDOW_SIZE, size_t HOP_SIZE, uint32_t SAMPLE_RATE = MAX30102_SAMPLES_PER_SECOND,
+		typename Math = algo::utils::float_math, bool BANDPASSED = false>
+class SlidingHeartRate {
+	using Filter = algo::design::HrFilter<SAMPLE_RATE, BANDPASSED>;
+	static const constexpr size_t SMOOTHING_SIZE = Filter::SMOOTHING_SIZE;
+	static const constexpr size_t GRADIENT_LAG = Filter::GRADIENT_LAG;
+
+	static_assert(HOP_SIZE > 0 && HOP_SIZE <= WINDOW_SIZE, "hop must be within the window");
+	static_assert(SMOOTHING_SIZE + GRADIENT_LAG < WINDOW_SIZE, "filters longer than analysis window");
+
+public:
+	SlidingHeartRate() { reset(); };
+	virtual ~SlidingHeartRate(){};
+
+	void reset(void){
+		_smoother.reset();
+		_gradient.reset();
+		_gradients.reset();
+		_since_hop = 0;
+		_heart_rate = 0;
+	}
+
+	// returns true when sample closed a hop on a full window and HR was updated
+	bool push(const TimestampedOxSample& sample){
+		int32_t smoothed, smoothed_ts, grad, grad_ts;
+		if (!_smoother.push(sample, smoothed, smoothed_ts)) return false;
+		if (!_gradient.push(smoothed, smoothed_ts, grad, grad_ts)) return false;
+		_gradients.push({grad_ts, grad});
+
+		if (++_since_hop < HOP_SIZE || !_gradients.full()) return false;
+		_since_hop = 0;
+
+		PROFILE_SCOPE(HeartRateSlidingHop);
+		using Gradient = algo::stages::TimedGradient;
+		const FieldSpan<Gradient, &Gradient::value> values{_gradients.segments()};
+		const FieldSpan<Gradient, &Gradient::ts> times{_gradients.segments()};
+		_heart_rate = algo::utils::hr_calculator(Math{}, values, times, _gradients.std_dev(), Filter::MIN_PEAK_SAMPLES);
+		return true;
+	};
+
+	uint32_t get_hr(void) {return _heart_rate;};
+
+private:
+	algo::stages::BoxSmoother<SMOOTHING_SIZE> _smoother;
+	algo::stages::LaggedGradient<GRADIENT_LAG, Math> _gradient;
+	algo::stages::GradientWindow<WINDOW_SIZE, Math, algo::stages::TimedGradient> _gradients;
+
+	size_t _since_hop;
+	uint32_t _heart_rate;
+};
+
+#endif /* INC_MAX30102_HEARTRATESLIDING_HPP_ */
@@ -0,0 +1,131 @@
+/*
+ * HeartRateStream.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#ifndef INC_MAX30102_HEARTRATESTREAM_HPP_
+#define INC_MAX30102_HEARTRATESTREAM_HPP_
+
+#include <stdint.h>
+#include "ox_data_structure.hpp"
+#include "algo_utils.hpp"
+#include "filter_design.hpp"
+#include "hr_stages.hpp"
+#include "profiler.hpp"
+#include "etl/array.h"
+
+/*
+ * Per-sample version of HeartRate pipeline. Same stages - box smoothing, gradient,
+ * std-dev threshold and peak detection - but every stage keeps running state,
+ * so push() costs constant work and HR is refreshed after every detected beat.
+ *
+ * SAMPLE_RATE - sps the filters are designed for (filter_design.hpp)
+ * STATS_SIZE  - gradient history used for std-dev threshold, also warm-up length
+ * INTERVALS   - beat intervals averaged into HR
+ * Math        - algo::utils::float_math or fixed_math
+ * BANDPASSED  - input comes through algo::filter::PpgBandpass, box smoothing is skipped
+ */
+template<uint32_t SAMPLE_RATE = MAX30102_SAMPLES_PER_SECOND, size_t STATS_SIZE = MAX30102_BUFFER_LENGTH, size_t INTERVALS = 8,
+		typename Math = algo::utils::float_math, bool BANDPASSED = false>
+class StreamingHeartRate {
+	using Filter = algo::design::HrFilter<SAMPLE_RATE, BANDPASSED>;
+	static const constexpr size_t SMOOTHING_SIZE = Filter::SMOOTHING_SIZE;
+	static const constexpr size_t GRADIENT_LAG = Filter::GRADIENT_LAG;
+
+public:
+	StreamingHeartRate() { reset(); };
+	virtual ~StreamingHeartRate(){};
+
+	void reset(void){
+		_smoother.reset();
+		_gradient.reset();
+		_gradients.reset();
+		_peak_time_sum = 0;
+		_samples_in_peak = 0;
+		_last_peak_ms = 0;
+		_last_peak_valid = false;
+		_interval_sum = 0;
+		_interval_count = 0;
+		_interval_index = 0;
+		_heart_rate = 0;
+	}
+
+	// returns true when sample completed a beat and HR was updated
+	bool push(const TimestampedOxSample& sample){
+		PROFILE_SCOPE(HeartRateStreamPush);
+		int32_t smoothed, smoothed_ts, grad, grad_ts;
+		if (!_smoother.push(sample, smoothed, smoothed_ts)) return false;
+		if (!_gradient.push(smoothed, smoothed_ts, grad, grad_ts)) return false;
+
+		_gradients.push(grad);
+		if (!_gradients.full()) return false;
+
+		// beats are timed by the newest smoothed sample, not by grad_ts as in SlidingHeartRate
+		return detect_peak(grad, smoothed_ts);
+	};
+
+	uint32_t get_hr(void) {return _heart_rate;};
+
+private:
+	static const constexpr uint32_t MIN_SAMPLES_IN_PEAK = Filter::MIN_PEAK_SAMPLES;
+	static const constexpr int32_t MAX_BEAT_INTERVAL_MS = 2000;
+
+	bool detect_peak(int32_t grad, int32_t ts){
+		if (grad < -_gradients.std_dev()){
+			_peak_time_sum += ts;
+			_samples_in_peak++;
+			return false;
+		}
+		if (_samples_in_peak == 0) return false;
+
+		const bool true_peak = _samples_in_peak >= MIN_SAMPLES_IN_PEAK;
+		const int32_t peak_ms = static_cast<int32_t>(_peak_time_sum / _samples_in_peak);
+		_peak_time_sum = 0;
+		_samples_in_peak = 0;
+		if (!true_peak) return false;
+
+		return add_beat(peak_ms);
+	}
+
+	bool add_beat(int32_t peak_ms){
+		const int32_t interval = peak_ms - _last_peak_ms;
+		const bool had_peak = _last_peak_valid;
+		_last_peak_ms = peak_ms;
+		_last_peak_valid = true;
+
+		// first beat or gap after lost contact - only a reference point
+		if (!had_peak || interval <= 0 || interval > MAX_BEAT_INTERVAL_MS) return false;
+
+		if (_interval_count == INTERVALS){
+			_interval_sum -= _intervals[_interval_index];
+		} else {
+			_interval_count++;
+		}
+		_intervals[_interval_index] = interval;
+		_interval_sum += interval;
+		_interval_index = (_interval_index + 1) % INTERVALS;
+
+		_heart_rate = static_cast<uint32_t>((60000 * _interval_count) / _interval_sum);
+		return true;
+	}
+
+	algo::stages::BoxSmoother<SMOOTHING_SIZE> _smoother;
+	algo::stages::LaggedGradient<GRADIENT_LAG, Math> _gradient;
+	algo::stages::GradientWindow<STATS_SIZE, Math> _gradients;
+
+	int64_t _peak_time_sum;
+	uint32_t _samples_in_peak;
+	int32_t _last_peak_ms;
+	bool _last_peak_valid;
+
+	etl::array<int32_t, INTERVALS> _intervals{};
+	int32_t _interval_sum;
+	size_t _interval_count;
+	size_t _interval_index;
+
+	uint32_t _heart_rate;
+};
+
+#endif /* INC_MAX30102_HEARTRATESTREAM_HPP_ */
@@ -70,13 +70,37 @@
 
 #define MAX30102_ADDRESS 0xAE	//(0x57<<1)
 //#define MAX30102_USE_INTERNAL_TEMPERATURE
+//#define MAX30102_VERIFY_REG_SHADOW	// compare register shadow with device on every field update
+//#define MAX30102_USE_STREAMING_HR	// per-beat HR engine instead of the sliding window one
+//#define MAX30102_USE_FIXED_POINT_HR	// integer only HR arithmetic, Max30102_Task never touches the FPU
+//#define MAX30102_USE_BANDPASS	// 0.5 - 4 Hz biquad band-pass on IR and RED as samples arrive, replaces HR box smoothing
 
+// host builds (Host/CMakeLists.txt) may override these two
+#ifndef MAX30102_MEASUREMENT_SECONDS
 #define MAX30102_MEASUREMENT_SECONDS 5
+#endif
+#ifndef MAX30102_SAMPLES_PER_SECOND
 #define MAX30102_SAMPLES_PER_SECOND	100 // 50, 100, 200, 400, 800, 100, 1600, 3200 sample rating
+#endif
 #define MAX30102_FIFO_ALMOST_FULL_SAMPLES 17
+#define MAX30102_FIFO_DEPTH 32
+#define MAX30102_FIFO_SAMPLE_BYTES 6	// 3 bytes RED + 3 bytes IR in SpO2 mode
 
 #define MAX30102_BUFFER_LENGTH	((MAX30102_MEASUREMENT_SECONDS+1)*MAX30102_SAMPLES_PER_SECOND)
 
+// acquisition -> Max30102_Task handoff, one full FIFO burst plus 250 ms of late draining
+#ifndef MAX30102_RING_LENGTH
+#define MAX30102_RING_LENGTH	(MAX30102_FIFO_DEPTH + MAX30102_SAMPLES_PER_SECOND / 4)
+#endif
+
+// sliding HR window - analysis length and how often a new HR is computed, in samples
+#ifndef MAX30102_HR_WINDOW_SAMPLES
+#define MAX30102_HR_WINDOW_SAMPLES	MAX30102_BUFFER_LENGTH
+#endif
+#ifndef MAX30102_HR_HOP_SAMPLES
+#define MAX30102_HR_HOP_SAMPLES	MAX30102_SAMPLES_PER_SECOND
+#endif
+
 //
 //	Calibration
 //
@@ -209,6 +233,14 @@ typedef enum{
 	MAX30102_OK 	= 1
 } MAX30102_STATUS;
 
+//
+//	FIFO acquisition mode
+//
+typedef enum{
+	MAX30102_ACQUISITION_BLOCKING 	= 0,	// HAL_I2C_Mem_Read, core waits for the transfer
+	MAX30102_ACQUISITION_DMA 		= 1		// HAL_I2C_Mem_Read_DMA, task sleeps until completion callback, then unpacks
+} MAX30102_ACQUISITION_MODE;
+
 //
 //	Functions
 //
@@ -216,6 +248,12 @@ MAX30102_STATUS Max30102_Init(I2C_HandleTypeDef *i2c);
 MAX30102_STATUS Max30102_ReadFifo(volatile uint32_t *pun_red_led, volatile uint32_t *pun_ir_led);
 MAX30102_STATUS Max30102_WriteReg(uint8_t uch_addr, uint8_t uch_data);
 MAX30102_STATUS Max30102_ReadReg(uint8_t uch_addr, uint8_t *puch_data);
+MAX30102_STATUS Max30102_WriteRegisterField(uint8_t Register, uint8_t Bit, uint8_t Length, uint8_t Value);
+//
+//	Register shadow
+//
+MAX30102_STATUS Max30102_SyncRegShadow(void);
+MAX30102_STATUS Max30102_VerifyRegShadow(void);
 //
 //	Interrupts
 //
@@ -226,7 +264,9 @@ MAX30102_STATUS Max30102_SetIntAmbientLightCancelationOvfEnabled(uint8_t Enable)
 #ifdef MAX30102_USE_INTERNAL_TEMPERATURE
 MAX30102_STATUS Max30102_SetIntInternalTemperatureReadyEnabled(uint8_t Enable);
 #endif
-void Max30102_InterruptCallback(void);
+MAX30102_STATUS Max30102_InterruptCallback(void);
+void Max30102_FifoDmaCompleteCallback(void);
+void Max30102_FifoDmaErrorCallback(void);
 //
 //	FIFO Configuration
 //
@@ -236,6 +276,9 @@ MAX30102_STATUS Max30102_FifoReadPointer(uint8_t Address);
 MAX30102_STATUS Max30102_FifoSampleAveraging(uint8_t Value);
 MAX30102_STATUS Max30102_FifoRolloverEnable(uint8_t Enable);
 MAX30102_STATUS Max30102_FifoAlmostFullValue(uint8_t Value); // 17-32 samples ready in FIFO
+MAX30102_STATUS Max30102_FifoPendingSamples(uint8_t *Count);
+MAX30102_STATUS Max30102_ReadFifoBurst(uint8_t Samples);
+MAX30102_STATUS Max30102_SetAcquisitionMode(MAX30102_ACQUISITION_MODE Mode);
 //
 //	Mode Configuration
 //
@@ -257,6 +300,8 @@ MAX30102_STATUS Max30102_Led2PulseAmplitude(uint8_t Value);
 //	Usage functions
 //
 void Max30102_Task(void);
-float get_hr(void);
+uint32_t get_hr(void);
+// samples lost because Max30102_Task did not keep up
+uint32_t Max30102_RingOverruns(void);
 
 #endif /* MAX30102_H_ */
@@ -13,15 +13,140 @@
 #include "etl/vector.h"
 #include "etl/mean.h"
 #include "etl/circular_buffer.h"
+#include "etl/standard_deviation.h"
 #include "ox_data_structure.hpp"
+#include "filter_design.hpp"
 #include <math.h>
+// packed 16 bit kernels, a host test defines it with emulated intrinsics
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis_compiler.h"
+#define ALGO_DSP_INTRINSICS 1
+#endif
 
+// Signal is anything indexable with size() and value_type - etl::array or an
+// OxFieldSpan over the sample ring, so a window is processed where it lies.
 namespace algo::utils{
 
-	template <typename T, const size_t WINDOW_SIZE, const size_t SIGNAL_SIZE>
-	void convolution(const etl::array<T, WINDOW_SIZE>& smoothing_window, etl::array<T, SIGNAL_SIZE>& signal){
+	/*
+	 * Arithmetic of the HR stages, passed as tag like box_window. float_math is
+	 * the reference, fixed_math keeps to integer ops so a task running the
+	 * pipeline never gets an FPU context. Samples are integer ADC levels and
+	 * timestamps integer ms, so fixed_math is Q0 with the ms -> s scale folded
+	 * into the arithmetic. Difference to float_math, same input:
+	 *  - slope: at most 1 (level/s), float rounding of t/1000 is within 2^-23
+	 *    relative, only matters next to an integer boundary or the MAX_GRADIENT clamp
+	 *  - standard deviation: at most 1, both truncate sqrt of the population
+	 *    variance, fixed one is exact
+	 *  - hr_calculator: at most 1 bpm while timestamps stay below ~2 days of
+	 *    uptime, float peak times in seconds lose resolution with uptime, the
+	 *    integer ms ones do not. Float path keeps at most 30 peaks per window,
+	 *    fixed one has no limit
+	 */
+	struct float_math{};
+	struct fixed_math{};
 
-		for (size_t i=0; i < SIGNAL_SIZE - WINDOW_SIZE; i++){
+	// change per second of v_diff over t_diff_ms (> 0), truncated toward zero
+	inline int32_t slope(float_math, int32_t v_diff, int32_t t_diff_ms){
+		float t_diff_sec = t_diff_ms;
+		t_diff_sec /= 1000;
+		return static_cast<int32_t>(v_diff / t_diff_sec);
+	}
+
+	// |v_diff| below 2^21 keeps the product in int32, smoothed 18 bit ADC levels are
+	inline int32_t slope(fixed_math, int32_t v_diff, int32_t t_diff_ms){
+		return v_diff * 1000 / t_diff_ms;
+	}
+
+	// floor(sqrt(value)), bit by bit
+	inline uint32_t isqrt(uint32_t value){
+		uint32_t root{0};
+		uint32_t bit{1UL << 30};
+		while (bit > value) bit >>= 2;
+		while (bit != 0){
+			if (value >= root + bit){
+				value -= root + bit;
+				root = (root >> 1) + bit;
+			} else {
+				root >>= 1;
+			}
+			bit >>= 2;
+		}
+		return root;
+	}
+
+	// population standard deviation from running sum and sum of squares of count values
+	inline int32_t standard_deviation(float_math, int64_t sum, int64_t sq_sum, size_t count){
+		if (count == 0) return 0;
+		const float mean = static_cast<float>(sum) / count;
+		const float variance = static_cast<float>(sq_sum) / count - mean * mean;
+		return variance > 0 ? static_cast<int32_t>(sqrtf(variance)) : 0;
+	}
+
+	// values below 2^31 / sqrt(count), gradients are clamped far lower
+	inline int32_t standard_deviation(fixed_math, int64_t sum, int64_t sq_sum, size_t count){
+		if (count == 0) return 0;
+		const int64_t n = static_cast<int64_t>(count);
+		const int64_t scaled_variance = n * sq_sum - sum * sum;
+		if (scaled_variance <= 0) return 0;
+		const uint64_t variance = static_cast<uint64_t>(scaled_variance) / static_cast<uint64_t>(n * n);
+		return static_cast<int32_t>(isqrt(variance > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(variance)));
+	}
+
+	template<typename Signal>
+	int32_t standard_deviation(float_math, const Signal& signal){
+		etl::standard_deviation<etl::standard_deviation_type::Population, int32_t> standard_deviation(signal.begin(), signal.end());
+		return static_cast<int32_t>(standard_deviation.get_standard_deviation());
+	}
+
+	template<typename Signal>
+	int32_t standard_deviation(fixed_math, const Signal& signal){
+		const size_t signal_size = signal.size();
+		int64_t sum{0}, sq_sum{0};
+		for (size_t i{0}; i < signal_size; i++){
+			const int64_t value = signal[i];
+			sum += value;
+			sq_sum += value * value;
+		}
+		return standard_deviation(fixed_math{}, sum, sq_sum, signal_size);
+	}
+
+	/*
+	 * Running sums of a gradient window as value enters and oldest leaves (0
+	 * while the window fills). Both are clamped gradients within int16, so
+	 * with the M4 DSP extension they share a word (PKHBT) and SMUSD / SMLSLD
+	 * add value - oldest and value^2 - oldest^2 with one instruction each.
+	 * The plain path gives the same sums, Host/tests/gradient_sums_match
+	 * checks both against each other.
+	 */
+	static_assert(algo::design::MAX_GRADIENT <= 0x8000, "clamped gradients have to fit a halfword");
+
+	inline void replace_in_sums_plain(int32_t value, int32_t oldest, int64_t& sum, int64_t& sq_sum){
+		sum += value - oldest;
+		sq_sum += static_cast<int64_t>(value) * value - static_cast<int64_t>(oldest) * oldest;
+	}
+
+#ifdef ALGO_DSP_INTRINSICS
+	inline void replace_in_sums_dsp(int32_t value, int32_t oldest, int64_t& sum, int64_t& sq_sum){
+		const uint32_t pair = __PKHBT(value, oldest, 16);
+		sum += static_cast<int32_t>(__SMUSD(pair, 0x00010001UL));
+		sq_sum = static_cast<int64_t>(__SMLSLD(pair, pair, static_cast<uint64_t>(sq_sum)));
+	}
+#endif
+
+	inline void replace_in_sums(int32_t value, int32_t oldest, int64_t& sum, int64_t& sq_sum){
+#ifdef ALGO_DSP_INTRINSICS
+		replace_in_sums_dsp(value, oldest, sum, sq_sum);
+#else
+		replace_in_sums_plain(value, oldest, sum, sq_sum);
+#endif
+	}
+
+	template <typename T, const size_t WINDOW_SIZE, typename Signal>
+	void convolution(const etl::array<T, WINDOW_SIZE>& smoothing_window, Signal& signal){
+		const size_t signal_size = signal.size();
+		if (signal_size <= WINDOW_SIZE) return;
+
+		for (size_t i=0; i < signal_size - WINDOW_SIZE; i++){
 			for (size_t j = 0; j < WINDOW_SIZE; j++){
 				if (j == 0){
 					signal[i] = signal[i + j] * smoothing_window[WINDOW_SIZE - 1 - j];
@@ -29,44 +154,130 @@ namespace algo::utils{
 					signal[i] = signal[i] + signal[i + j] * smoothing_window[WINDOW_SIZE - 1 - j];
 				}
 			}
-			signal[i] = signal[i] / WINDOW_SIZE;
+			// signed division, a size_t divisor would turn a negative sum unsigned
+			signal[i] = signal[i] / static_cast<T>(WINDOW_SIZE);
+		};
+
+		for (size_t i=signal_size - WINDOW_SIZE; i < signal_size; i++){
+			signal[i] = signal[signal_size - WINDOW_SIZE - 1];
+		};
+	}
+
+	// all ones window - convolution with it is a box filter and resolves to the running sum overload
+	template <typename T, const size_t WINDOW_SIZE>
+	struct box_window{
+		static const constexpr size_t size = WINDOW_SIZE;
+	};
+
+	// same output as convolution with etl::array of ones, O(1) per sample instead of O(WINDOW_SIZE)
+	template <typename T, const size_t WINDOW_SIZE, typename Signal>
+	void convolution(const box_window<T, WINDOW_SIZE>&, Signal& signal){
+		const size_t signal_size = signal.size();
+		if (signal_size <= WINDOW_SIZE) return;
+		T sum{0};
+
+		for (size_t j = 0; j < WINDOW_SIZE; j++){
+			sum = sum + signal[j];
+		}
+
+		for (size_t i=0; i < signal_size - WINDOW_SIZE; i++){
+			const T oldest = signal[i];
+			signal[i] = sum / static_cast<T>(WINDOW_SIZE);
+			sum = sum - oldest + signal[i + WINDOW_SIZE];
 		};
 
-		for (size_t i=SIGNAL_SIZE - WINDOW_SIZE; i < SIGNAL_SIZE; i++){
-			signal[i] = signal[SIGNAL_SIZE - WINDOW_SIZE - 1];
+		for (size_t i=signal_size - WINDOW_SIZE; i < signal_size; i++){
+			signal[i] = signal[signal_size - WINDOW_SIZE - 1];
 		};
 	}
 
-	template<typename T, size_t SIGNAL_SIZE>
-	void gradient(etl::array<T, SIGNAL_SIZE>& signal, const etl::array<T, SIGNAL_SIZE>& signal_time){
-		static const constexpr uint32_t MAX_GRAD_VAL = 12000;
-		for (size_t i{0}; i < SIGNAL_SIZE - 1; i++){
-			float t_diff_sec = signal_time[i+1] - signal_time[i];
-			t_diff_sec /= 1000;
-			const auto v_diff = signal[i+1] - signal[i];
-			const auto sig = static_cast<T>(v_diff / t_diff_sec);
-			signal[i] =  abs(sig) < MAX_GRAD_VAL ? sig : 0;
+	// slope with the motion clamp, zero padded tail of a partly filled stream repeats timestamps
+	template<typename Math>
+	int32_t clamped_slope(int32_t v_diff, int32_t t_diff_ms){
+		if (t_diff_ms <= 0) return 0;
+		const int32_t sig = slope(Math{}, v_diff, t_diff_ms);
+		return static_cast<uint32_t>(abs(sig)) < algo::design::MAX_GRADIENT ? sig : 0;
+	}
+
+	// lag - samples the difference is taken across, algo::design::gradient_lag() of the rate
+	template<typename Math = float_math, typename Signal, typename Time>
+	void gradient(Signal& signal, const Time& signal_time, const size_t lag = 1){
+		const size_t signal_size = signal.size();
+		for (size_t i{0}; i + lag < signal_size; i++){
+			signal[i] = clamped_slope<Math>(signal[i+lag] - signal[i], signal_time[i+lag] - signal_time[i]);
+		}
+		// no next sample, left as raw level it would dominate the standard deviation
+		for (size_t i{signal_size > lag ? signal_size - lag : 0}; i < signal_size; i++) signal[i] = 0;
+	}
+
+	/*
+	 * convolution(box_window), gradient() and standard_deviation() in one pass
+	 * with the same result: signal is left holding the gradient, its standard
+	 * deviation is returned. Every level is read as it enters and as it leaves
+	 * the box sum, every gradient written once and summed while in registers,
+	 * instead of four walks over the window. The last LAG smoothed values wait
+	 * in a small ring, the raw levels under them are overwritten only after
+	 * the box sum has let them go. Statistics are int64 running sums of the
+	 * clamped gradients - exact, no per sample division as Welford would need.
+	 */
+	template<typename Math, size_t LAG, typename T, size_t WINDOW_SIZE, typename Signal, typename Time>
+	int32_t smoothed_gradient(const box_window<T, WINDOW_SIZE>&, Signal& signal, const Time& signal_time){
+		static_assert(LAG > 0, "gradient needs a later sample");
+		const size_t signal_size = signal.size();
+		// convolution leaves windows not longer than the box as they are, a box of one is no smoothing
+		const size_t smoothed_end = WINDOW_SIZE > 1 && signal_size > WINDOW_SIZE ? signal_size - WINDOW_SIZE : 0;
+		etl::array<T, LAG + 1> smoothed{};
+		T sum{0}, level{0};
+		int64_t grad_sum{0}, grad_sq_sum{0};
+
+		if (smoothed_end != 0){
+			for (size_t j{0}; j < WINDOW_SIZE; j++) sum = sum + signal[j];
+		}
+
+		for (size_t j{0}; j < signal_size; j++){
+			if (j < smoothed_end){
+				level = sum / static_cast<T>(WINDOW_SIZE);
+				sum = sum - signal[j] + signal[j + WINDOW_SIZE];
+			} else if (smoothed_end == 0){
+				level = signal[j];
+			}
+			// past smoothed_end the last smoothed level repeats, as convolution pads
+
+			smoothed[j % (LAG + 1)] = level;
+			if (j < LAG) continue;
+			const size_t i = j - LAG;
+			const int32_t grad = clamped_slope<Math>(level - smoothed[i % (LAG + 1)], signal_time[j] - signal_time[i]);
+			signal[i] = grad;
+			grad_sum += grad;
+			grad_sq_sum += static_cast<int64_t>(grad) * grad;
 		}
+		for (size_t i{signal_size > LAG ? signal_size - LAG : 0}; i < signal_size; i++) signal[i] = 0;
+
+		return standard_deviation(Math{}, grad_sum, grad_sq_sum, signal_size);
 	}
 
-	template<typename T, size_t SIGNAL_SIZE>
-	T welfords_algorithm(const etl::array<T, SIGNAL_SIZE>& signal){
+	template<typename Signal>
+	typename Signal::value_type welfords_algorithm(const Signal& signal){
+		using T = typename Signal::value_type;
+		const size_t signal_size = signal.size();
 		float mean{0}, M2{0};
 		T variance{0};
-		for (size_t i{0}; i < SIGNAL_SIZE; i++){
+		if (signal_size == 0) return variance;
+		for (size_t i{0}; i < signal_size; i++){
 			const auto sample = signal[i];
 			float delta = sample - mean;
 			mean = mean + delta / (i + 1);
 			M2 = M2 + delta * (sample - mean);
 		}
-		variance = static_cast<T>(M2 / SIGNAL_SIZE);
+		variance = static_cast<T>(M2 / signal_size);
 		return sqrt(variance);
 	}
 
-	template<typename T, size_t SIZE>
-	float mean(const etl::array<T, SIZE>& data, const uint32_t exclude_from_end = 0){
+	template<typename Signal>
+	float mean(const Signal& data, const uint32_t exclude_from_end = 0){
 		uint32_t sum{0};
-		const uint32_t size{SIZE - exclude_from_end};
+		const uint32_t size{static_cast<uint32_t>(data.size()) - exclude_from_end};
+		if (size == 0) return 0;
 
 		for (uint32_t i{0}; i < size; i++){
 			sum += data[i];
@@ -74,51 +285,80 @@ namespace algo::utils{
 		return sum / size;
 	}
 
-	template<typename T, size_t SIZE>
-	void diff(etl::array<T, SIZE>& data){
-		for (uint32_t i{0}; i < SIZE - 1; i++){
+	template<typename Signal>
+	void diff(Signal& data){
+		for (uint32_t i{0}; i + 1 < data.size(); i++){
 			data[i] = data[i+1] - data[i];
 		}
 	}
 
-	template<typename T, size_t SIGNAL_SIZE>
-	float hr_calculator(const etl::array<T, SIGNAL_SIZE>& signal, const etl::array<T, SIGNAL_SIZE>& signal_time, const T& std_dev){
+	// min_samples_in_peak - algo::design::min_peak_samples() of the rate
+	template<typename Signal, typename Time, typename T>
+	float hr_calculator(const Signal& signal, const Time& signal_time, const T& std_dev, const uint32_t min_samples_in_peak){
+		const size_t signal_size = signal.size();
 		etl::vector<float, 30> true_peak_times{};
-		float temp[30]{};
-		uint32_t peak_time{0}, samples_in_peak{0};
+		uint32_t peak_start{0}, peak_offsets{0}, samples_in_peak{0};
 
-		for (size_t i{0}; i < SIGNAL_SIZE; i++){
+		for (size_t i{0}; i < signal_size; i++){
 			if (signal[i] < - std_dev){
-				peak_time += signal_time[i];
+				// offsets from the first sample, a sum of absolute timestamps overflows with uptime
+				if (samples_in_peak == 0) peak_start = signal_time[i];
+				peak_offsets += signal_time[i] - peak_start;
 				samples_in_peak++;
 			} else if (samples_in_peak != 0){
-				if (samples_in_peak > 4){
-					const float ts = (peak_time / samples_in_peak) / 1000.0;
+				if (samples_in_peak >= min_samples_in_peak){
+					const float ts = (peak_start + peak_offsets / samples_in_peak) / 1000.0;
 					true_peak_times.push_back(ts);
 				}
-				peak_time = 0;
+				peak_offsets = 0;
 				samples_in_peak = 0;
 			}
 		}
 
 		if (true_peak_times.size() <= 1) return 0.0;
 
-	    for (int i{0}; i < true_peak_times.size(); i++){
-	    	temp[i] = true_peak_times[i];
-	    }
-
 	    for(auto it = true_peak_times.begin(); it != true_peak_times.end() - 1; it++ ){
 	    	*it = *(it+1) - *it;
 	    }
 	    true_peak_times.pop_back();
 
-	    for (int i{0}; i < true_peak_times.size(); i++){
-	    	temp[i] = true_peak_times[i];
-	    }
-
 	    const auto mean = etl::mean<float>(true_peak_times.begin(), true_peak_times.end()).get_mean();
 		return mean == 0.0 ? 0.0 : 60.0 / mean;
 	}
+
+	template<typename Signal, typename Time, typename T>
+	uint32_t hr_calculator(float_math, const Signal& signal, const Time& signal_time, const T& std_dev,
+			const uint32_t min_samples_in_peak){
+		return static_cast<uint32_t>(hr_calculator(signal, signal_time, std_dev, min_samples_in_peak));
+	}
+
+	// same peaks as above, mean beat interval telescopes to (last - first) / (peaks - 1)
+	template<typename Signal, typename Time, typename T>
+	uint32_t hr_calculator(fixed_math, const Signal& signal, const Time& signal_time, const T& std_dev,
+			const uint32_t min_samples_in_peak){
+		const size_t signal_size = signal.size();
+		uint32_t peak_start{0}, peak_offsets{0}, samples_in_peak{0};
+		uint32_t peaks{0}, first_peak_ms{0}, last_peak_ms{0};
+
+		for (size_t i{0}; i < signal_size; i++){
+			if (signal[i] < - std_dev){
+				if (samples_in_peak == 0) peak_start = signal_time[i];
+				peak_offsets += signal_time[i] - peak_start;
+				samples_in_peak++;
+			} else if (samples_in_peak != 0){
+				if (samples_in_peak >= min_samples_in_peak){
+					last_peak_ms = peak_start + peak_offsets / samples_in_peak;
+					if (peaks == 0) first_peak_ms = last_peak_ms;
+					peaks++;
+				}
+				peak_offsets = 0;
+				samples_in_peak = 0;
+			}
+		}
+
+		if (peaks <= 1 || last_peak_ms <= first_peak_ms) return 0;
+		return (60000 * (peaks - 1)) / (last_peak_ms - first_peak_ms);
+	}
 }
 
 #endif /* INC_MAX30102_HEARTRATE_H_ */
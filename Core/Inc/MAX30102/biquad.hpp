@@ -0,0 +1,170 @@
+/*
+ * biquad.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#ifndef INC_MAX30102_BIQUAD_HPP_
+#define INC_MAX30102_BIQUAD_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ox_data_structure.hpp"
+#include "algo_utils.hpp"
+#include "filter_design.hpp"
+#include "etl/array.h"
+
+namespace algo::filter{
+
+	/*
+	 * Biquad section, direct form II transposed - two state words, 5 multiplies
+	 * per sample. Coefficients come from algo::design, reset() zeroes the state.
+	 */
+	template<typename Math>
+	class Biquad;
+
+	template<>
+	class Biquad<algo::utils::float_math>{
+	public:
+		constexpr explicit Biquad(const algo::design::Biquad& c) :
+			_b0{static_cast<float>(c.b0)}, _b1{static_cast<float>(c.b1)}, _b2{static_cast<float>(c.b2)},
+			_a1{static_cast<float>(c.a1)}, _a2{static_cast<float>(c.a2)} {}
+
+		void reset(void){
+			_s1 = 0;
+			_s2 = 0;
+		}
+
+		int32_t process(int32_t x){
+			const float y = _b0 * x + _s1;
+			_s1 = _b1 * x - _a1 * y + _s2;
+			_s2 = _b2 * x - _a2 * y;
+			return static_cast<int32_t>(y < 0 ? y - 0.5f : y + 0.5f);
+		}
+
+	private:
+		float _b0, _b1, _b2, _a1, _a2;
+		float _s1{0}, _s2{0};
+	};
+
+	/*
+	 * Integer DF2T: coefficients Q28 (|c| < 8), state Q28 in int64, output fed
+	 * back with 12 fractional bits. Inputs up to 2^21 keep every product in
+	 * int64, MAX30102 levels are 18 bit. b1 and a1 are rounded so that the
+	 * coefficient sums stay exact - DC gain of a high-pass stays zero however
+	 * close to z = 1 its poles are at high sample rates.
+	 */
+	template<>
+	class Biquad<algo::utils::fixed_math>{
+	public:
+		constexpr explicit Biquad(const algo::design::Biquad& c) :
+			_b0{algo::design::to_fixed(c.b0, COEFF_BITS)},
+			_b1{algo::design::to_fixed(c.b0 + c.b1 + c.b2, COEFF_BITS) - algo::design::to_fixed(c.b0, COEFF_BITS) -
+				algo::design::to_fixed(c.b2, COEFF_BITS)},
+			_b2{algo::design::to_fixed(c.b2, COEFF_BITS)},
+			_a1{algo::design::to_fixed(1.0 + c.a1 + c.a2, COEFF_BITS) - algo::design::to_fixed(1.0, COEFF_BITS) -
+				algo::design::to_fixed(c.a2, COEFF_BITS)},
+			_a2{algo::design::to_fixed(c.a2, COEFF_BITS)} {}
+
+		void reset(void){
+			_s1 = 0;
+			_s2 = 0;
+		}
+
+		int32_t process(int32_t x){
+			const int64_t acc = static_cast<int64_t>(_b0) * x + _s1;
+			const int64_t y = shift(acc, COEFF_BITS - FEEDBACK_BITS);
+			_s1 = static_cast<int64_t>(_b1) * x - shift(static_cast<int64_t>(_a1) * y, FEEDBACK_BITS) + _s2;
+			_s2 = static_cast<int64_t>(_b2) * x - shift(static_cast<int64_t>(_a2) * y, FEEDBACK_BITS);
+			return static_cast<int32_t>(shift(acc, COEFF_BITS));
+		}
+
+	private:
+		static const constexpr uint32_t COEFF_BITS = 28;
+		static const constexpr uint32_t FEEDBACK_BITS = 12;
+
+		// rounded, a floor here biases the state and the high-pass poles turn that into offset
+		static int64_t shift(int64_t value, uint32_t bits){ return (value + (1LL << (bits - 1))) >> bits; }
+
+		int32_t _b0, _b1, _b2, _a1, _a2;
+		int64_t _s1{0}, _s2{0};
+	};
+
+	// sections run in order
+	template<typename Math, size_t STAGES>
+	class BiquadCascade{
+	public:
+		constexpr explicit BiquadCascade(const etl::array<Biquad<Math>, STAGES>& stages) : _stages{stages} {}
+
+		void reset(void){
+			for (auto& stage : _stages) stage.reset();
+		}
+
+		int32_t process(int32_t x){
+			for (auto& stage : _stages) x = stage.process(x);
+			return x;
+		}
+
+	private:
+		etl::array<Biquad<Math>, STAGES> _stages;
+	};
+
+	/*
+	 * PPG band-pass front end, IR and RED each through their own cascade.
+	 * Removes DC and baseline wander below the heart rate band and noise
+	 * above it. Per sample in the acquisition path or in batch over an
+	 * OxStream / OxWindow, timestamps are left as they are.
+	 *
+	 * First sample after reset() is taken as the channel level and subtracted
+	 * from everything after it. The high-pass in front makes the output the
+	 * same, but the filter starts settled instead of ringing on an 18 bit DC
+	 * step, and float state keeps its precision at high sample rates.
+	 */
+	template<uint32_t SAMPLE_RATE = MAX30102_SAMPLES_PER_SECOND, typename Math = algo::utils::float_math>
+	class PpgBandpass{
+	public:
+		void reset(void){
+			_ir.reset();
+			_red.reset();
+			_started = false;
+		}
+
+		TimestampedOxSample process(const TimestampedOxSample& sample){
+			if (!_started){
+				_started = true;
+				_ir_level = sample.ir;
+				_red_level = sample.red;
+			}
+			return {sample.ts, _ir.process(sample.ir - _ir_level), _red.process(sample.red - _red_level)};
+		}
+
+		// whole window from a fresh state, in place
+		template<typename Window>
+		void process(Window& window){
+			reset();
+			auto&& time = window.get_time();
+			auto&& ir = window.get_ir();
+			auto&& red = window.get_red();
+			for (size_t i{0}; i < ir.size(); i++){
+				const TimestampedOxSample filtered = process({time[i], ir[i], red[i]});
+				ir[i] = filtered.ir;
+				red[i] = filtered.red;
+			}
+		}
+
+	private:
+		// MIN_HEART_RATE_HZ high-pass then MAX_HEART_RATE_HZ low-pass, 2nd order Butterworth each, designed at compile time
+		static const constexpr etl::array<Biquad<Math>, 2> SECTIONS{{
+			Biquad<Math>{algo::design::highpass(SAMPLE_RATE, algo::design::MIN_HEART_RATE_HZ)},
+			Biquad<Math>{algo::design::lowpass(SAMPLE_RATE, algo::design::MAX_HEART_RATE_HZ)}}};
+
+		BiquadCascade<Math, 2> _ir{SECTIONS};
+		BiquadCascade<Math, 2> _red{SECTIONS};
+		int32_t _ir_level{0};
+		int32_t _red_level{0};
+		bool _started{false};
+	};
+}
+
+#endif /* INC_MAX30102_BIQUAD_HPP_ */
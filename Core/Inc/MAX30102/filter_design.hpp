@@ -0,0 +1,141 @@
+/*
+ * filter_design.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Compile time design of the HR pipeline filters. Everything that used to
+ *  be a sample count tuned for 100 sps is given here in Hz or ms and turned
+ *  into samples for the configured rate, so engines instantiated at another
+ *  MAX30102_SAMPLES_PER_SECOND get the same filter in time. All functions
+ *  are constexpr, results end up as template arguments and constants.
+ */
+
+#ifndef INC_MAX30102_FILTER_DESIGN_HPP_
+#define INC_MAX30102_FILTER_DESIGN_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace algo::design{
+
+	// heart rate band the filters keep, 30 - 240 bpm
+	static const constexpr double MIN_HEART_RATE_HZ = 0.5;
+	static const constexpr double MAX_HEART_RATE_HZ = 4.0;
+	// box smoothing -3 dB point - the fastest pulse passes, 11 taps at 100 sps
+	static const constexpr double SMOOTHING_CUTOFF_HZ = MAX_HEART_RATE_HZ;
+	// shortest run of gradients below threshold taken as a beat, 5 samples at 100 sps
+	static const constexpr uint32_t MIN_PEAK_MS = 50;
+	// gradient is taken across at least this span, timestamps are whole ms
+	static const constexpr uint32_t GRADIENT_SPAN_MS = 10;
+	// gradients above this (IR level per second) are motion, not pulse - per second so rate independent
+	static const constexpr uint32_t MAX_GRADIENT = 12000;
+
+	static const constexpr double PI = 3.14159265358979323846;
+
+	constexpr size_t round_to_size(double value){
+		return value < 1.0 ? 1 : static_cast<size_t>(value + 0.5);
+	}
+
+	// samples covering duration_ms at sample_rate, at least one
+	constexpr size_t samples(uint32_t sample_rate, uint32_t duration_ms){
+		return round_to_size(static_cast<double>(sample_rate) * duration_ms / 1000.0);
+	}
+
+	// moving average length with -3 dB at cutoff_hz, fc ~ 0.443 fs / N
+	constexpr size_t box_length(uint32_t sample_rate, double cutoff_hz){
+		return round_to_size(0.443 * sample_rate / cutoff_hz);
+	}
+
+	constexpr size_t smoothing_length(uint32_t sample_rate){ return box_length(sample_rate, SMOOTHING_CUTOFF_HZ); }
+	constexpr size_t min_peak_samples(uint32_t sample_rate){ return samples(sample_rate, MIN_PEAK_MS); }
+	constexpr size_t gradient_lag(uint32_t sample_rate){ return samples(sample_rate, GRADIENT_SPAN_MS); }
+
+	// sin and cos by Taylor series after reduction to [-pi, pi], double precision for design angles
+	constexpr double reduce_angle(double x){
+		while (x > PI) x -= 2.0 * PI;
+		while (x < -PI) x += 2.0 * PI;
+		return x;
+	}
+
+	constexpr double sin(double x){
+		x = reduce_angle(x);
+		double term{x}, sum{x};
+		for (int n{1}; n < 20; n++){
+			term *= -x * x / ((2 * n) * (2 * n + 1));
+			sum += term;
+		}
+		return sum;
+	}
+
+	constexpr double cos(double x){
+		x = reduce_angle(x);
+		double term{1.0}, sum{1.0};
+		for (int n{1}; n < 20; n++){
+			term *= -x * x / ((2 * n - 1) * (2 * n));
+			sum += term;
+		}
+		return sum;
+	}
+
+	/*
+	 * Biquad normalised to a0 = 1, y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2.
+	 * Designs follow the RBJ audio EQ cookbook, bilinear transform with the
+	 * centre / corner frequency prewarped.
+	 */
+	struct Biquad{
+		double b0, b1, b2, a1, a2;
+	};
+
+	static const constexpr double BUTTERWORTH_Q = 0.70710678118654752440;
+
+	constexpr Biquad normalise(double b0, double b1, double b2, double a0, double a1, double a2){
+		return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
+	}
+
+	constexpr Biquad lowpass(uint32_t sample_rate, double cutoff_hz, double q = BUTTERWORTH_Q){
+		const double w0 = 2.0 * PI * cutoff_hz / sample_rate;
+		const double alpha = sin(w0) / (2.0 * q);
+		const double c = cos(w0);
+		return normalise((1.0 - c) / 2.0, 1.0 - c, (1.0 - c) / 2.0, 1.0 + alpha, -2.0 * c, 1.0 - alpha);
+	}
+
+	constexpr Biquad highpass(uint32_t sample_rate, double cutoff_hz, double q = BUTTERWORTH_Q){
+		const double w0 = 2.0 * PI * cutoff_hz / sample_rate;
+		const double alpha = sin(w0) / (2.0 * q);
+		const double c = cos(w0);
+		return normalise((1.0 + c) / 2.0, -(1.0 + c), (1.0 + c) / 2.0, 1.0 + alpha, -2.0 * c, 1.0 - alpha);
+	}
+
+	// constant 0 dB peak gain at centre_hz
+	constexpr Biquad bandpass(uint32_t sample_rate, double centre_hz, double q){
+		const double w0 = 2.0 * PI * centre_hz / sample_rate;
+		const double alpha = sin(w0) / (2.0 * q);
+		const double c = cos(w0);
+		return normalise(alpha, 0.0, -alpha, 1.0 + alpha, -2.0 * c, 1.0 - alpha);
+	}
+
+	// coefficient in fixed point with frac_bits fractional bits, rounded to nearest
+	constexpr int32_t to_fixed(double value, uint32_t frac_bits){
+		const double scaled = value * static_cast<double>(1LL << frac_bits);
+		return static_cast<int32_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+	}
+
+	// filter parameters for one sample rate, what the HR engines are instantiated with.
+	// BANDPASSED - input already went through algo::filter::PpgBandpass, its low-pass
+	// takes the place of the box smoothing
+	template<uint32_t SAMPLE_RATE, bool BANDPASSED = false>
+	struct HrFilter{
+		static_assert(SAMPLE_RATE > 0, "sample rate must be positive");
+		static const constexpr size_t SMOOTHING_SIZE = BANDPASSED ? 1 : smoothing_length(SAMPLE_RATE);
+		static const constexpr size_t MIN_PEAK_SAMPLES = min_peak_samples(SAMPLE_RATE);
+		static const constexpr size_t GRADIENT_LAG = gradient_lag(SAMPLE_RATE);
+	};
+
+	static_assert(smoothing_length(100) == 11 && min_peak_samples(100) == 5 && gradient_lag(100) == 1,
+			"unexpected filter lengths at 100 sps");
+	static_assert(sin(PI / 6) - 0.5 < 1e-12 && 0.5 - sin(PI / 6) < 1e-12 && cos(PI) + 1.0 < 1e-12,
+			"constexpr sin/cos out of precision");
+}
+
+#endif /* INC_MAX30102_FILTER_DESIGN_HPP_ */
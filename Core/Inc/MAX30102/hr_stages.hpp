@@ -0,0 +1,159 @@
+/*
+ * hr_stages.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#ifndef INC_MAX30102_HR_STAGES_HPP_
+#define INC_MAX30102_HR_STAGES_HPP_
+
+#include <stdint.h>
+#include "ox_data_structure.hpp"
+#include "algo_utils.hpp"
+#include "spsc_ring.hpp"
+#include "etl/array.h"
+
+/*
+ * Per-sample stages of the HR pipeline, shared by SlidingHeartRate and
+ * StreamingHeartRate. Each one keeps its running state and does constant work
+ * per sample, with the same arithmetic as the batch stages in algo::utils.
+ */
+namespace algo::stages{
+
+	// causal box filter, output is stamped with the oldest sample in window like the batch convolution
+	template<size_t SIZE>
+	class BoxSmoother{
+	public:
+		BoxSmoother() { reset(); }
+
+		void reset(void){
+			_sum = 0;
+			_index = 0;
+			_filled = false;
+		}
+
+		// false until SIZE samples came in
+		bool push(const TimestampedOxSample& sample, int32_t& smoothed, int32_t& smoothed_ts){
+			if constexpr (SIZE == 1){
+				smoothed = sample.ir;
+				smoothed_ts = sample.ts;
+				return true;
+			}
+			if (_filled) _sum -= _levels[_index];
+			_levels[_index] = sample.ir;
+			_times[_index] = sample.ts;
+			_sum += sample.ir;
+			_index = (_index + 1) % SIZE;
+			if (_index == 0) _filled = true;
+
+			if (!_filled) return false;
+
+			smoothed = _sum / static_cast<int32_t>(SIZE);
+			smoothed_ts = _times[_index];
+			return true;
+		}
+
+	private:
+		etl::array<int32_t, SIZE> _levels{};
+		etl::array<int32_t, SIZE> _times{};
+		int32_t _sum;
+		size_t _index;
+		bool _filled;
+	};
+
+	// clamped slope across LAG smoothed samples, belongs to the older one as in algo::utils::gradient
+	template<size_t LAG, typename Math>
+	class LaggedGradient{
+	public:
+		LaggedGradient() { reset(); }
+
+		void reset(void){
+			_index = 0;
+			_count = 0;
+		}
+
+		// false until LAG samples came in, grad_ts is the timestamp of the sample LAG back
+		bool push(int32_t level, int32_t ts, int32_t& grad, int32_t& grad_ts){
+			const bool ready = _count == LAG;
+			if (ready){
+				grad = algo::utils::clamped_slope<Math>(level - _levels[_index], ts - _times[_index]);
+				grad_ts = _times[_index];
+			} else {
+				_count++;
+			}
+			// oldest at _index once filled
+			_levels[_index] = level;
+			_times[_index] = ts;
+			_index = (_index + 1) % LAG;
+			return ready;
+		}
+
+	private:
+		etl::array<int32_t, LAG> _levels{};
+		etl::array<int32_t, LAG> _times{};
+		size_t _index;
+		size_t _count;
+	};
+
+	struct TimedGradient{
+		int32_t ts;
+		int32_t value;
+	};
+
+	inline int32_t gradient_value(int32_t gradient){ return gradient; }
+	inline int32_t gradient_value(const TimedGradient& gradient){ return gradient.value; }
+
+	/*
+	 * Last SIZE gradients and their population standard deviation. Entry is
+	 * the bare gradient or TimedGradient when the gradients are scanned later.
+	 * int64 running sums, the oldest gradient leaves as a new one comes in
+	 * (algo::utils::replace_in_sums, packed on the M4).
+	 */
+	template<size_t SIZE, typename Math, typename Entry = int32_t>
+	class GradientWindow{
+	public:
+		GradientWindow() { reset(); }
+
+		void reset(void){
+			_sum = 0;
+			_sq_sum = 0;
+			_count = 0;
+			_index = 0;
+		}
+
+		void push(const Entry& entry){
+			int32_t oldest{0};
+			if (_count == SIZE){
+				oldest = gradient_value(_history[_index]);
+			} else {
+				_count++;
+			}
+			_history[_index] = entry;
+			algo::utils::replace_in_sums(gradient_value(entry), oldest, _sum, _sq_sum);
+			_index = (_index + 1) % SIZE;
+		}
+
+		bool full(void) const { return _count == SIZE; }
+
+		int32_t std_dev(void) const {
+			return algo::utils::standard_deviation(Math{}, _sum, _sq_sum, _count);
+		}
+
+		// kept entries, oldest first - once full the write index is where the oldest one sits
+		SpscSegments<Entry> segments(void){
+			if (!full()) return {&_history[0], _count, &_history[0], 0};
+			return {&_history[_index], SIZE - _index, &_history[0], _index};
+		}
+
+	private:
+		etl::array<Entry, SIZE> _history{};
+		int64_t _sum;
+		int64_t _sq_sum;
+		size_t _count;
+		size_t _index;
+	};
+
+}
+
+#endif /* INC_MAX30102_HR_STAGES_HPP_ */
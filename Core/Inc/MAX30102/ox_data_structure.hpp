@@ -8,8 +8,8 @@
 #ifndef INC_MAX30102_OX_DATA_STRUCTURE_HPP_
 #define INC_MAX30102_OX_DATA_STRUCTURE_HPP_
 
-#include "etl/circular_buffer.h"
 #include "etl/array.h"
+#include "spsc_ring.hpp"
 
 struct OxSample{
 	int32_t ir;
@@ -107,13 +107,14 @@ struct TimestampedOxSample{
 	}
 };
 
-struct OxStream{
-		using array = etl::array<int32_t, MAX30102_BUFFER_LENGTH>;
+template<size_t SIZE>
+struct BasicOxStream{
+		using array = etl::array<int32_t, SIZE>;
 		array ts;
 		array ir;
 		array red;
 
-		OxStream() : _iterator{0} {}
+		BasicOxStream() : _iterator{0} {}
 
 		void clear(void){
 			ts.fill(0);
@@ -123,7 +124,7 @@ struct OxStream{
 		}
 
 		bool append(const TimestampedOxSample& sample){
-			if (_iterator == MAX30102_BUFFER_LENGTH) return false;
+			if (_iterator == SIZE) return false;
 
 			ts[_iterator] = sample.ts;
 			ir[_iterator] = sample.ir;
@@ -151,8 +152,74 @@ struct OxStream{
 
 };
 
-using OxReadData =  etl::circular_buffer<TimestampedOxSample, MAX30102_BUFFER_LENGTH>;
+/*
+ * One int32_t field of S across a run of records held in place in up to two
+ * segments (ring wrap), oldest first. Indexes like etl::array so algo_utils.hpp
+ * templates run on it directly, writes go to the records.
+ */
+template<typename S, int32_t S::* FIELD>
+class FieldSpan{
+public:
+	using value_type = int32_t;
+
+	class iterator{
+	public:
+		iterator(const FieldSpan* span, size_t index) : _span{span}, _index{index} {}
+
+		int32_t& operator*() const { return (*_span)[_index]; }
+		iterator& operator++() { _index++; return *this; }
+		bool operator==(const iterator& other) const { return _index == other._index; }
+		bool operator!=(const iterator& other) const { return _index != other._index; }
+
+	private:
+		const FieldSpan* _span;
+		size_t _index;
+	};
+
+	explicit FieldSpan(const SpscSegments<S>& segments) : _segments{segments} {}
+
+	int32_t& operator[](size_t i) const {
+		return i < _segments.first_size ? _segments.first[i].*FIELD : _segments.second[i - _segments.first_size].*FIELD;
+	}
+
+	size_t size(void) const { return _segments.size(); }
+
+	iterator begin(void) const { return iterator(this, 0); }
+
+	iterator end(void) const { return iterator(this, size()); }
+
+private:
+	SpscSegments<S> _segments;
+};
+
+template<int32_t TimestampedOxSample::* FIELD>
+using OxFieldSpan = FieldSpan<TimestampedOxSample, FIELD>;
+
+// samples in place, same accessors as BasicOxStream without the SoA copy
+class OxWindow{
+public:
+	explicit OxWindow(const SpscSegments<TimestampedOxSample>& segments) : _segments{segments} {}
+
+	OxFieldSpan<&TimestampedOxSample::ts> get_time(void) const { return OxFieldSpan<&TimestampedOxSample::ts>(_segments); }
+
+	OxFieldSpan<&TimestampedOxSample::ir> get_ir(void) const { return OxFieldSpan<&TimestampedOxSample::ir>(_segments); }
+
+	OxFieldSpan<&TimestampedOxSample::red> get_red(void) const { return OxFieldSpan<&TimestampedOxSample::red>(_segments); }
+
+	size_t size(void) const { return _segments.size(); }
+
+private:
+	SpscSegments<TimestampedOxSample> _segments;
+};
+
+// buffer and ring lengths come from MAX30102.hpp, sample type alone is usable without it
+#ifdef MAX30102_BUFFER_LENGTH
+using OxStream = BasicOxStream<MAX30102_BUFFER_LENGTH>;
 using OxWriteData =  etl::array<TimestampedOxSample, MAX30102_BUFFER_LENGTH>;
+#endif
+#ifdef MAX30102_RING_LENGTH
+using OxReadData =  SpscRing<TimestampedOxSample, MAX30102_RING_LENGTH>;
+#endif
 
 
 #endif /* INC_MAX30102_OX_DATA_STRUCTURE_HPP_ */
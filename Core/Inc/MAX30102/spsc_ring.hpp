@@ -0,0 +1,106 @@
+/*
+ * spsc_ring.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#ifndef INC_MAX30102_SPSC_RING_HPP_
+#define INC_MAX30102_SPSC_RING_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "etl/array.h"
+#include "etl/atomic.h"
+
+/*
+ * Wait-free single producer / single consumer ring.
+ * Producer (acquisition) only writes _head, consumer (processing) only writes _tail,
+ * so neither side has to lock or disable interrupts. When the ring is full push()
+ * drops the new item and counts an overrun instead of blocking.
+ */
+// published items in place, oldest first, second segment is non-empty when they wrap
+template<typename T>
+struct SpscSegments{
+	T* first;
+	size_t first_size;
+	T* second;
+	size_t second_size;
+
+	size_t size(void) const { return first_size + second_size; }
+};
+
+template<typename T, size_t SIZE>
+class SpscRing{
+public:
+	SpscRing() : _head{0}, _tail{0}, _overruns{0} {}
+
+	// producer side
+	bool push(const T& item){
+		const size_t head = _head.load(etl::memory_order_relaxed);
+		const size_t next = increment(head);
+		if (next == _tail.load(etl::memory_order_acquire)){
+			_overruns.store(_overruns.load(etl::memory_order_relaxed) + 1, etl::memory_order_relaxed);
+			return false;
+		}
+		_buffer[head] = item;
+		_head.store(next, etl::memory_order_release);
+		return true;
+	}
+
+	// consumer side
+	bool pop(T& item){
+		const size_t tail = _tail.load(etl::memory_order_relaxed);
+		if (tail == _head.load(etl::memory_order_acquire)) return false;
+		item = _buffer[tail];
+		_tail.store(increment(tail), etl::memory_order_release);
+		return true;
+	}
+
+	// consumer side - items published so far, stay owned by the consumer until drop()
+	SpscSegments<T> peek(void){
+		const size_t tail = _tail.load(etl::memory_order_relaxed);
+		const size_t head = _head.load(etl::memory_order_acquire);
+		if (head >= tail) return {&_buffer[tail], head - tail, &_buffer[0], 0};
+		return {&_buffer[tail], CAPACITY - tail, &_buffer[0], head};
+	}
+
+	// consumer side - releases count oldest items, at most what peek() returned
+	void drop(size_t count){
+		size_t tail = _tail.load(etl::memory_order_relaxed) + count;
+		if (tail >= CAPACITY) tail -= CAPACITY;
+		_tail.store(tail, etl::memory_order_release);
+	}
+
+	// consumer side - drops everything published so far
+	void clear(void){
+		_tail.store(_head.load(etl::memory_order_acquire), etl::memory_order_release);
+	}
+
+	size_t size(void) const {
+		const size_t head = _head.load(etl::memory_order_acquire);
+		const size_t tail = _tail.load(etl::memory_order_acquire);
+		return head >= tail ? head - tail : CAPACITY - tail + head;
+	}
+
+	bool empty(void) const { return size() == 0; }
+
+	bool full(void) const { return size() == SIZE; }
+
+	static constexpr size_t max_size(void) { return SIZE; }
+
+	uint32_t overruns(void) const { return _overruns.load(etl::memory_order_relaxed); }
+
+private:
+	// one slot stays free to tell full from empty
+	static const constexpr size_t CAPACITY = SIZE + 1;
+
+	static size_t increment(size_t index) { return ++index == CAPACITY ? 0 : index; }
+
+	etl::array<T, CAPACITY> _buffer;
+	etl::atomic<size_t> _head;
+	etl::atomic<size_t> _tail;
+	etl::atomic<uint32_t> _overruns;
+};
+
+#endif /* INC_MAX30102_SPSC_RING_HPP_ */
@@ -0,0 +1,55 @@
+/*
+ * app_log.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Buffered asynchronous log output. Producers (tasks and ISRs) copy text
+ *  into a lock-free ring in O(1), a low priority task drains it to ITM
+ *  stimulus port 0 with 32 bit writes. printf goes through the same ring
+ *  (_write override), so nothing spins on ITM in the caller's context.
+ */
+
+#ifndef INC_APP_LOG_H_
+#define INC_APP_LOG_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ring capacity in 4 byte cells, power of two
+#ifndef APP_LOG_BUFFER_CELLS
+#define APP_LOG_BUFFER_CELLS 256
+#endif
+
+#ifndef APP_LOG_DRAIN_PERIOD_MS
+#define APP_LOG_DRAIN_PERIOD_MS 5
+#endif
+
+// longest single App_LogPrintf message, longer output is truncated
+#ifndef APP_LOG_LINE_LENGTH
+#define APP_LOG_LINE_LENGTH 96
+#endif
+
+// creates the drain task, logging works before that and is buffered
+void App_LogCreateTask(void);
+
+// any context, whole message is queued or dropped, returns bytes queued
+int App_LogWrite(const char *data, int len);
+
+// formats on caller's stack and queues as one message, any task context
+int App_LogPrintf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+// moves everything published so far to the output
+void App_LogDrain(void);
+
+// messages dropped because the ring was full
+uint32_t App_LogDropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_APP_LOG_H_ */
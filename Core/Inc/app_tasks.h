@@ -0,0 +1,24 @@
+/*
+ * app_tasks.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Application task graph. Kept out of main.cpp so the same tasks and
+ *  HAL callbacks can run on the FreeRTOS POSIX port (Host/posix).
+ */
+
+#ifndef INC_APP_TASKS_H_
+#define INC_APP_TASKS_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+extern TaskHandle_t db_led_task_handle;
+extern TaskHandle_t max30102_task_handle;
+extern TaskHandle_t max30102_acq_task_handle;
+
+// creates all application tasks, scheduler is started by the caller
+void App_CreateTasks(void);
+
+#endif /* INC_APP_TASKS_H_ */
@@ -0,0 +1,109 @@
+/*
+ * log_ring.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#ifndef INC_LOG_RING_HPP_
+#define INC_LOG_RING_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "etl/array.h"
+#include "etl/atomic.h"
+
+/*
+ * Lock-free multi producer / single consumer byte ring (bounded Vyukov queue
+ * with block reservation). Cells carry up to 4 bytes so the consumer can move
+ * data out in 32 bit words.
+ *
+ * Producers - tasks and ISRs - reserve all cells of a message with one CAS on
+ * the enqueue position, copy and publish each cell by its sequence number.
+ * A message either fits whole or is dropped and counted, so write() never
+ * blocks or spins on the consumer. Messages from different producers never
+ * interleave. The consumer stops at the first unpublished cell, a producer
+ * preempted between reserve and publish only delays output behind it.
+ */
+template<size_t CELLS>
+class LogRing{
+	static_assert(CELLS >= 2 && (CELLS & (CELLS - 1)) == 0, "CELLS must be a power of two");
+
+public:
+	static const constexpr size_t CELL_BYTES = 4;
+
+	LogRing() : _enqueue{0}, _dequeue{0}, _dropped{0} {
+		for (size_t i{0}; i < CELLS; i++) _cells[i].seq.store(i, etl::memory_order_relaxed);
+	}
+
+	// any context, returns false when the message did not fit
+	bool write(const char* data, size_t len){
+		if (len == 0) return true;
+		const size_t cells = (len + CELL_BYTES - 1) / CELL_BYTES;
+		if (cells > CELLS){
+			drop();
+			return false;
+		}
+
+		uint32_t pos = _enqueue.load(etl::memory_order_relaxed);
+		while (true){
+			// consumer frees cells in order, so the last one being free means all are
+			const uint32_t last = pos + cells - 1;
+			const uint32_t seq = _cells[last & MASK].seq.load(etl::memory_order_acquire);
+			if (static_cast<int32_t>(seq - last) < 0){
+				drop();
+				return false;
+			}
+			if (_enqueue.compare_exchange_weak(pos, pos + cells, etl::memory_order_relaxed)) break;
+		}
+
+		for (size_t i{0}; i < cells; i++){
+			Cell& cell = _cells[(pos + i) & MASK];
+			const size_t n = len > CELL_BYTES ? CELL_BYTES : len;
+			cell.word = 0;
+			memcpy(&cell.word, data, n);
+			cell.len = static_cast<uint8_t>(n);
+			cell.seq.store(pos + i + 1, etl::memory_order_release);
+			data += n;
+			len -= n;
+		}
+		return true;
+	}
+
+	// consumer side, false when next cell is not published yet
+	bool read(uint32_t& word, uint8_t& len){
+		Cell& cell = _cells[_dequeue & MASK];
+		if (cell.seq.load(etl::memory_order_acquire) != _dequeue + 1) return false;
+		word = cell.word;
+		len = cell.len;
+		cell.seq.store(_dequeue + CELLS, etl::memory_order_release);
+		_dequeue++;
+		return true;
+	}
+
+	uint32_t dropped(void) const { return _dropped.load(etl::memory_order_relaxed); }
+
+	static constexpr size_t max_bytes(void) { return CELLS * CELL_BYTES; }
+
+private:
+	static const constexpr uint32_t MASK = CELLS - 1;
+
+	struct Cell {
+		etl::atomic<uint32_t> seq;
+		uint32_t word;
+		uint8_t len;
+	};
+
+	void drop(void){
+		uint32_t dropped = _dropped.load(etl::memory_order_relaxed);
+		while (!_dropped.compare_exchange_weak(dropped, dropped + 1, etl::memory_order_relaxed));
+	}
+
+	etl::array<Cell, CELLS> _cells;
+	etl::atomic<uint32_t> _enqueue;
+	uint32_t _dequeue;
+	etl::atomic<uint32_t> _dropped;
+};
+
+#endif /* INC_LOG_RING_HPP_ */
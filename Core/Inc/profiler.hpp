@@ -0,0 +1,107 @@
+/*
+ * profiler.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Scoped timers for firmware hot paths. On target ticks are Cortex-M4 DWT
+ *  CYCCNT cycles, on host builds std::chrono nanoseconds. Every site keeps
+ *  count/min/max/total in a static table that dump() prints on demand. On
+ *  target TaskStats_Report() dumps it through the log after the task table.
+ *
+ *  Cost per scope is two CYCCNT reads and a handful of compares and adds, so
+ *  it stays enabled in release builds. Define PROFILER_ENABLED to 0 to
+ *  compile all scopes out.
+ *
+ *  A site is updated without locking - enter each site from one context
+ *  (one task or one ISR), dump() from anywhere may see a torn entry.
+ */
+
+#ifndef INC_PROFILER_HPP_
+#define INC_PROFILER_HPP_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#if defined(__arm__)
+#include "stm32f4xx.h"
+#else
+#include <chrono>
+#endif
+
+namespace profiler {
+
+	enum class Site : uint8_t {
+		Max30102Interrupt,
+		CollectFifo,
+		HeartRateProcess,
+		SmoothedGradient,
+		HrCalculator,
+		HeartRateStreamPush,
+		HeartRateSlidingHop,
+		Count
+	};
+
+	struct SiteStats {
+		uint32_t count;
+		uint32_t min;
+		uint32_t max;
+		uint64_t total;
+	};
+
+	extern SiteStats table[static_cast<size_t>(Site::Count)];
+
+	// enables the cycle counter, call once before the scheduler starts
+	void init(void);
+	void reset(void);
+	void dump(FILE* out = stdout);
+	// same table through a printf-like function, e.g. App_LogPrintf
+	void dump(int (*print)(const char* format, ...));
+
+	static inline uint32_t now(void){
+#if defined(__arm__)
+		return DWT->CYCCNT;
+#else
+		return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	// unsigned difference stays right across one CYCCNT wrap (51 s at 84 MHz)
+	static inline void record(Site site, uint32_t ticks){
+		auto& s = table[static_cast<size_t>(site)];
+		if (s.count == 0 || ticks < s.min) s.min = ticks;
+		if (ticks > s.max) s.max = ticks;
+		s.total += ticks;
+		s.count++;
+	}
+
+	class Scope {
+	public:
+		explicit Scope(Site site) : _site{site}, _start{now()} {}
+		~Scope(){ record(_site, now() - _start); }
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const Site _site;
+		const uint32_t _start;
+	};
+
+}
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(site) profiler::Scope PROFILER_CONCAT(profile_scope_, __LINE__){profiler::Site::site}
+#else
+#define PROFILE_SCOPE(site) do {} while(0)
+#endif
+
+#endif /* INC_PROFILER_HPP_ */
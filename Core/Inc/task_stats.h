@@ -0,0 +1,34 @@
+/*
+ * task_stats.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Periodic per task CPU load and stack high-water mark report, from FreeRTOS
+ *  run time statistics (configGENERATE_RUN_TIME_STATS, TIM2 based on target).
+ */
+
+#ifndef INC_TASK_STATS_H_
+#define INC_TASK_STATS_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifndef TASK_STATS_PERIOD_MS
+#define TASK_STATS_PERIOD_MS 10000
+#endif
+
+// upper bound of tasks in the system, idle and timer task included
+#ifndef TASK_STATS_MAX_TASKS
+#define TASK_STATS_MAX_TASKS 10
+#endif
+
+extern TaskHandle_t task_stats_task_handle;
+
+// creates the reporting task, lowest application priority
+void TaskStats_CreateTask(void);
+
+// prints CPU % since previous call and free stack of every task, then profiler sites
+void TaskStats_Report(void);
+
+#endif /* INC_TASK_STATS_H_ */
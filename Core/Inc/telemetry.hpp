@@ -0,0 +1,84 @@
+/*
+ * telemetry.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Framed binary telemetry: raw sample batches, HR results and diagnostics.
+ *  Frame on the wire is COBS(payload) followed by a 0x00 delimiter, so a
+ *  receiver resynchronises on the next zero after any corruption:
+ *
+ *    payload = type u8 | seq u16 | body | crc16 u16
+ *
+ *  All fields little endian, crc16 is CRC-16/CCITT-FALSE over type..body.
+ *  Every message type has its own sequence counter and a single producer,
+ *  so a gap in seq means lost frames of that type. Bodies:
+ *
+ *    SAMPLES      ts_ms u32 | count u8 | count x (dt_ms u8 | ir u24 | red u24)
+ *    HEART_RATE   ts_ms u32 | bpm x10 u16 | flags u8 (bit0 finger, bit1 valid)
+ *    DIAGNOSTICS  ts_ms u32 | ring overruns u32 | log dropped u32 |
+ *                 trace dropped u32 | telemetry dropped u32
+ *
+ *  Frames are queued whole in a lock-free ring and drained by the log drain
+ *  task to a Transport - USART1 by default, ITM port 2 with
+ *  TELEMETRY_TRANSPORT_UART 0. scripts/telemetry.py decodes the stream.
+ */
+
+#ifndef INC_TELEMETRY_HPP_
+#define INC_TELEMETRY_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ox_data_structure.hpp"
+#include "transport.hpp"
+
+#ifndef TELEMETRY_SAMPLES_PER_FRAME
+#define TELEMETRY_SAMPLES_PER_FRAME 25
+#endif
+
+// 1 - USART1 with DMA, 0 - ITM stimulus port 2 (debug probe)
+#ifndef TELEMETRY_TRANSPORT_UART
+#define TELEMETRY_TRANSPORT_UART 1
+#endif
+
+namespace telemetry {
+
+	enum class MessageType : uint8_t {
+		Samples = 0x01,
+		HeartRate = 0x02,
+		Diagnostics = 0x03,
+		Count
+	};
+
+	struct Diagnostics {
+		uint32_t ring_overruns;
+		uint32_t log_dropped;
+		uint32_t trace_dropped;
+		uint32_t telemetry_dropped;
+	};
+
+	// acquisition task only, a SAMPLES frame goes out every TELEMETRY_SAMPLES_PER_FRAME samples
+	void push_sample(const TimestampedOxSample& sample);
+	void flush_samples(void);
+
+	void send_heart_rate(int32_t ts, uint32_t bpm, bool finger_on);
+	void send_diagnostics(int32_t ts, const Diagnostics& diagnostics);
+
+	// moves queued frames to the output, called by the log drain task
+	void drain(void);
+
+	// frames dropped because the ring was full
+	uint32_t dropped(void);
+
+	// replaces the default output, nullptr drops frames (host default)
+	void set_transport(Transport* out);
+
+	uint16_t crc16(const uint8_t* data, size_t len);
+
+	// out needs len + len / 254 + 1 bytes, returns encoded length without delimiter
+	size_t cobs_encode(const uint8_t* data, size_t len, uint8_t* out);
+
+}
+
+#endif /* INC_TELEMETRY_HPP_ */
@@ -0,0 +1,108 @@
+/*
+ * trace.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Deferred formatting binary trace. TRACE("fmt", args...) does no formatting
+ *  on target: the format string goes to the trace_fmt ELF section, which the
+ *  linker script keeps out of flash (INFO), and a record of raw 32 bit words
+ *  goes to a lock-free ring:
+ *
+ *    word 0   - format string offset in trace_fmt << 4 | argument count
+ *    word 1   - timestamp, profiler::now() (DWT cycles, ns on host)
+ *    word 2.. - arguments, integers and pointers as is, floats as IEEE bits
+ *
+ *  The log drain task moves records to ITM stimulus port 1 (port 0 carries
+ *  text), scripts/trace_decoder.py resolves offsets against the ELF.
+ *  Arguments are at most 32 bit and %s is rejected at compile time - the
+ *  string would be gone by the time the host reads the record.
+ */
+
+#ifndef INC_TRACE_HPP_
+#define INC_TRACE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "profiler.hpp"
+
+extern "C" const char __start_trace_fmt[];
+
+namespace trace {
+
+	static const constexpr size_t MAX_ARGS = 15;
+	static const constexpr uint32_t ARGS_BITS = 4;
+
+	// queues one record, any context, false when the ring is full
+	bool write(const uint32_t* words, size_t count);
+
+	// moves queued records to the output, called by the log drain task
+	void drain(void);
+
+	// records dropped because the ring was full
+	uint32_t dropped(void);
+
+#if !defined(__arm__)
+	// host builds have no ITM, records go to a file, nullptr drops them
+	void set_output(FILE* out);
+#endif
+
+	constexpr bool has_string_arg(const char* fmt){
+		for (size_t i{0}; fmt[i] != '\0'; i++){
+			if (fmt[i] != '%') continue;
+			i++;
+			if (fmt[i] == '%') continue;
+			while (fmt[i] != '\0' && !((fmt[i] >= 'a' && fmt[i] <= 'z') || (fmt[i] >= 'A' && fmt[i] <= 'Z'))) i++;
+			// skip length modifiers
+			while (fmt[i] == 'h' || fmt[i] == 'l' || fmt[i] == 'z' || fmt[i] == 'j' || fmt[i] == 't') i++;
+			if (fmt[i] == 's') return true;
+			if (fmt[i] == '\0') return false;
+		}
+		return false;
+	}
+
+	template<typename T>
+	static inline uint32_t to_word(T value){
+		static_assert(sizeof(T) <= sizeof(uint32_t), "trace arguments are at most 32 bit");
+		return static_cast<uint32_t>(value);
+	}
+
+	static inline uint32_t to_word(float value){
+		uint32_t word;
+		memcpy(&word, &value, sizeof(word));
+		return word;
+	}
+
+	// %f arguments are promoted by habit, 32 bit float is enough for the log
+	static inline uint32_t to_word(double value){ return to_word(static_cast<float>(value)); }
+
+	template<typename T>
+	static inline uint32_t to_word(T* value){ return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value)); }
+
+	template<typename... Args>
+	static inline bool record(const char* fmt, Args... args){
+		static_assert(sizeof...(Args) <= MAX_ARGS, "too many trace arguments");
+		const uint32_t id = static_cast<uint32_t>(fmt - __start_trace_fmt);
+		const uint32_t words[2 + sizeof...(Args)] = {
+			(id << ARGS_BITS) | static_cast<uint32_t>(sizeof...(Args)),
+			profiler::now(),
+			to_word(args)...
+		};
+		return write(words, 2 + sizeof...(Args));
+	}
+
+}
+
+#define TRACE(fmt, ...) \
+	do { \
+		static_assert(!trace::has_string_arg(fmt), "%s can not be traced, strings are not copied"); \
+		trace::record([]{ \
+			static const char trace_fmt_string[] __attribute__((section("trace_fmt"), used)) = fmt; \
+			return &trace_fmt_string[0]; \
+		}(), ##__VA_ARGS__); \
+	} while(0)
+
+#endif /* INC_TRACE_HPP_ */
@@ -0,0 +1,101 @@
+/*
+ * transport.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Byte sink behind the telemetry stream. ITM needs a debug probe attached,
+ *  UartTransport (uart_transport.hpp) works on deployed units, host builds
+ *  write to a file or a pty. Writers never block: the caller checks
+ *  writable() and keeps whatever did not fit queued on its side.
+ */
+
+#ifndef INC_TRANSPORT_HPP_
+#define INC_TRANSPORT_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(__arm__)
+#include "stm32f4xx.h"
+#endif
+
+class Transport{
+public:
+	// bytes write() accepts right now
+	virtual size_t writable(void) const = 0;
+	// single writer, returns bytes accepted
+	virtual size_t write(const uint8_t* data, size_t len) = 0;
+	// hands out what has been written so far
+	virtual void flush(void) {}
+
+protected:
+	~Transport() = default;
+};
+
+#if defined(__arm__)
+// ITM stimulus port, has to be enabled by the debugger (TER), output is dropped otherwise.
+// A probe that stops draining SWO leaves the port full, writable() then reports no room.
+class ItmTransport : public Transport{
+public:
+	explicit ItmTransport(uint8_t port) : _port{port} {}
+
+	size_t writable(void) const override {
+		if (!enabled()) return SIZE_MAX;
+		return ITM->PORT[_port].u32 != 0UL ? sizeof(uint32_t) : 0;
+	}
+
+	size_t write(const uint8_t* data, size_t len) override {
+		if (!enabled()) return len;
+		size_t i{0};
+		for (; i + 4 <= len; i += 4){
+			if (!ready()) return i;
+			ITM->PORT[_port].u32 = static_cast<uint32_t>(data[i]) | static_cast<uint32_t>(data[i + 1]) << 8 |
+					static_cast<uint32_t>(data[i + 2]) << 16 | static_cast<uint32_t>(data[i + 3]) << 24;
+		}
+		for (; i < len; i++){
+			if (!ready()) return i;
+			ITM->PORT[_port].u8 = data[i];
+		}
+		return len;
+	}
+
+private:
+	// a draining probe frees the FIFO within a few SWO bit times
+	static const constexpr uint32_t READY_POLLS = 1000;
+
+	bool enabled(void) const {
+		return (ITM->TCR & ITM_TCR_ITMENA_Msk) != 0 && (ITM->TER & (1UL << _port)) != 0;
+	}
+
+	bool ready(void) const {
+		for (uint32_t poll{0}; poll < READY_POLLS; poll++){
+			if (ITM->PORT[_port].u32 != 0UL) return true;
+		}
+		return false;
+	}
+
+	const uint8_t _port;
+};
+#else
+// host builds, nullptr drops everything
+class FileTransport : public Transport{
+public:
+	explicit FileTransport(FILE* file) : _file{file} {}
+
+	size_t writable(void) const override { return SIZE_MAX; }
+
+	size_t write(const uint8_t* data, size_t len) override {
+		if (_file != nullptr) fwrite(data, 1, len, _file);
+		return len;
+	}
+
+	void flush(void) override { if (_file != nullptr) fflush(_file); }
+
+private:
+	FILE* const _file;
+};
+#endif
+
+#endif /* INC_TRANSPORT_HPP_ */
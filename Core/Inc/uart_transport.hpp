@@ -0,0 +1,56 @@
+/*
+ * uart_transport.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Double buffered USART1 TX. The writer fills one buffer while DMA sends
+ *  the other, a full buffer or flush() hands it to DMA and swaps, so the
+ *  CPU only copies bytes in. The DMA complete interrupt just releases the
+ *  buffer in flight, the next transfer is started by the writer.
+ *
+ *  On host the peripheral is replaced by Host/posix/posix_usart.cpp, which
+ *  plays the DMA transfer into a pty at the configured baud rate.
+ */
+
+#ifndef INC_UART_TRANSPORT_HPP_
+#define INC_UART_TRANSPORT_HPP_
+
+#include "transport.hpp"
+#include "etl/atomic.h"
+
+// size of each of the two TX buffers, one DMA transfer at most
+#ifndef UART_TRANSPORT_BUFFER_BYTES
+#define UART_TRANSPORT_BUFFER_BYTES 256
+#endif
+
+class UartTransport : public Transport{
+	static_assert(UART_TRANSPORT_BUFFER_BYTES <= 0xFFFF, "DMA transfer length is 16 bit");
+
+public:
+	size_t writable(void) const override;
+	size_t write(const uint8_t* data, size_t len) override;
+	void flush(void) override;
+
+	// DMA complete interrupt
+	void tx_complete(void);
+
+	// transfers started and bytes handed to DMA so far
+	uint32_t transfers(void) const { return _transfers; }
+	uint32_t bytes_sent(void) const { return _bytes_sent; }
+
+private:
+	void start(void);
+
+	uint8_t _buffers[2][UART_TRANSPORT_BUFFER_BYTES];
+	size_t _fill{0};
+	size_t _len{0};
+	etl::atomic<bool> _busy{false};
+	uint32_t _transfers{0};
+	uint32_t _bytes_sent{0};
+};
+
+// USART1, owns the DMA2 stream7 complete callback
+extern UartTransport uart_transport;
+
+#endif /* INC_UART_TRANSPORT_HPP_ */
@@ -69,22 +69,48 @@
 #include "i2c.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include "semphr.h"
 
 #include "MAX30102/MAX30102.hpp"
-#include "MAX30102/HeartRate.hpp"
+#include "MAX30102/HeartRateStream.hpp"
+#include "MAX30102/HeartRateSliding.hpp"
+#include "MAX30102/biquad.hpp"
 #include "ox_data_structure.hpp"
+#include "profiler.hpp"
+#include "trace.hpp"
+#include "telemetry.hpp"
 
 #define I2C_TIMEOUT	100
+#define I2C_RETRIES	3
 
 I2C_HandleTypeDef *i2c_max30102;
 
 OxReadData read_ox_buffer{};
-OxStream write_ox_stream{};
 
 TimestampedOxSample last_sample;
 
-HeartRate hr_algo{};
-float HR{0};
+#ifdef MAX30102_USE_FIXED_POINT_HR
+using HrMath = algo::utils::fixed_math;
+#else
+using HrMath = algo::utils::float_math;
+#endif
+
+#ifdef MAX30102_USE_BANDPASS
+static const constexpr bool HrBandpassed = true;
+// runs in the acquisition path, restarted from Max30102_Task whenever the ring is dropped
+algo::filter::PpgBandpass<MAX30102_SAMPLES_PER_SECOND, HrMath> ox_bandpass{};
+static volatile bool RestartBandpass{true};
+#else
+static const constexpr bool HrBandpassed = false;
+#endif
+
+#ifdef MAX30102_USE_STREAMING_HR
+StreamingHeartRate<MAX30102_SAMPLES_PER_SECOND, MAX30102_BUFFER_LENGTH, 8, HrMath, HrBandpassed> hr_engine{};
+#else
+SlidingHeartRate<MAX30102_HR_WINDOW_SAMPLES, MAX30102_HR_HOP_SAMPLES, MAX30102_SAMPLES_PER_SECOND, HrMath, HrBandpassed> hr_engine{};
+#endif
+// integer, so readers of get_hr() need no FPU context
+uint32_t HR{0};
 
 volatile uint32_t CollectedSamples{0};
 volatile uint8_t IsFingerOnScreen{0};
@@ -92,15 +118,55 @@ volatile uint8_t IsFingerOnScreen{0};
 typedef enum
 {
 	MAX30102_STATE_BEGIN,
-	MAX30102_STATE_CALIBRATE,
-	MAX30102_STATE_CALCULATE_HR,
-	MAX30102_STATE_COLLECT_NEXT_PORTION
+	MAX30102_STATE_MEASURE
 }MAX30102_STATE;
 
 MAX30102_STATE StateMachine;
 
+MAX30102_ACQUISITION_MODE AcquisitionMode{MAX30102_ACQUISITION_BLOCKING};
+
+// Burst buffer has to outlive the call in DMA mode
+static uint8_t FifoBurstData[MAX30102_FIFO_DEPTH * MAX30102_FIFO_SAMPLE_BYTES];
+static volatile uint8_t FifoDmaError{0};
+
+// Acquisition task and Max30102_Task both talk to the sensor
+static SemaphoreHandle_t I2cBusMutex{NULL};
+static SemaphoreHandle_t FifoDmaDone{NULL};
+
+static void Max30102_LockBus(void)
+{
+	if(I2cBusMutex != NULL) xSemaphoreTake(I2cBusMutex, portMAX_DELAY);
+}
+
+static void Max30102_UnlockBus(void)
+{
+	if(I2cBusMutex != NULL) xSemaphoreGive(I2cBusMutex);
+}
+
+//
+//	Register shadow
+//	Write-through copy of configuration registers (0x02 - 0x21), filled once after reset.
+//	Field updates take the old value from here, so they cost a single write.
+//
+static uint8_t RegShadow[REG_TEMP_CONFIG - REG_INTR_ENABLE_1 + 1];
+static uint8_t RegShadowValid{0};
+
+// FIFO pointers, FIFO data and temperature registers are changed by the device itself
+static bool Max30102_IsRegShadowed(uint8_t Register)
+{
+	if(Register < REG_INTR_ENABLE_1 || Register > REG_TEMP_CONFIG) return false;
+	if(Register >= REG_FIFO_WR_PTR && Register <= REG_FIFO_DATA) return false;
+	if(Register >= REG_TEMP_INTR) return false;
+	return true;
+}
+
 MAX30102_STATUS Max30102_WriteReg(uint8_t uch_addr, uint8_t uch_data)
-{	auto const status = HAL_I2C_Mem_Write(i2c_max30102, MAX30102_ADDRESS, uch_addr, 1, &uch_data, 1, I2C_TIMEOUT);
+{
+	Max30102_LockBus();
+	auto const status = HAL_I2C_Mem_Write(i2c_max30102, MAX30102_ADDRESS, uch_addr, 1, &uch_data, 1, I2C_TIMEOUT);
+	if(status == HAL_OK && Max30102_IsRegShadowed(uch_addr))
+		RegShadow[uch_addr - REG_INTR_ENABLE_1] = uch_data;
+	Max30102_UnlockBus();
 	if(status == HAL_OK)
 		return MAX30102_OK;
 	return MAX30102_ERROR;
@@ -108,24 +174,96 @@ MAX30102_STATUS Max30102_WriteReg(uint8_t uch_addr, uint8_t uch_data)
 
 MAX30102_STATUS Max30102_ReadReg(uint8_t uch_addr, uint8_t *puch_data)
 {
-	if(HAL_I2C_Mem_Read(i2c_max30102, MAX30102_ADDRESS, uch_addr, 1, puch_data, 1, I2C_TIMEOUT) == HAL_OK)
+	Max30102_LockBus();
+	auto const status = HAL_I2C_Mem_Read(i2c_max30102, MAX30102_ADDRESS, uch_addr, 1, puch_data, 1, I2C_TIMEOUT);
+	Max30102_UnlockBus();
+	if(status == HAL_OK)
 		return MAX30102_OK;
 	return MAX30102_ERROR;
 }
 
-MAX30102_STATUS Max30102_WriteRegisterBit(uint8_t Register, uint8_t Bit, uint8_t Value)
+MAX30102_STATUS Max30102_SyncRegShadow(void)
 {
+	RegShadowValid = 0;
+
+	// register pointer does not auto-increment past FIFO_DATA, read around it
+	Max30102_LockBus();
+	auto status = HAL_I2C_Mem_Read(i2c_max30102, MAX30102_ADDRESS, REG_INTR_ENABLE_1, 1,
+			&RegShadow[0], REG_FIFO_RD_PTR - REG_INTR_ENABLE_1 + 1, I2C_TIMEOUT);
+	if(status == HAL_OK)
+		status = HAL_I2C_Mem_Read(i2c_max30102, MAX30102_ADDRESS, REG_FIFO_CONFIG, 1,
+				&RegShadow[REG_FIFO_CONFIG - REG_INTR_ENABLE_1], REG_TEMP_CONFIG - REG_FIFO_CONFIG + 1, I2C_TIMEOUT);
+	Max30102_UnlockBus();
+
+	if(status != HAL_OK)
+		return MAX30102_ERROR;
+
+	RegShadowValid = 1;
+	return MAX30102_OK;
+}
+
+//
+//	Diagnostics - compares shadow with device, returns error on the first mismatch
+//
+MAX30102_STATUS Max30102_VerifyRegShadow(void)
+{
+	uint8_t tmp;
+
+	if(!RegShadowValid)
+		return MAX30102_ERROR;
+
+	for(uint8_t reg = REG_INTR_ENABLE_1; reg <= REG_TEMP_CONFIG; reg++)
+	{
+		if(!Max30102_IsRegShadowed(reg)) continue;
+		if(MAX30102_OK != Max30102_ReadReg(reg, &tmp))
+			return MAX30102_ERROR;
+		if(tmp != RegShadow[reg - REG_INTR_ENABLE_1])
+			return MAX30102_ERROR;
+	}
+	return MAX30102_OK;
+}
+
+static MAX30102_STATUS Max30102_ReadRegShadow(uint8_t Register, uint8_t *Value)
+{
+	if(!RegShadowValid || !Max30102_IsRegShadowed(Register))
+		return Max30102_ReadReg(Register, Value);
+
+	*Value = RegShadow[Register - REG_INTR_ENABLE_1];
+#ifdef MAX30102_VERIFY_REG_SHADOW
 	uint8_t tmp;
 	if(MAX30102_OK != Max30102_ReadReg(Register, &tmp))
 		return MAX30102_ERROR;
-	tmp &= ~(1<<Bit);
-	tmp |= (Value&0x01)<<Bit;
+	if(tmp != *Value)
+		return MAX30102_ERROR;
+#endif
+	return MAX30102_OK;
+}
+
+//
+//	Bit and Length follow register field defines - Bit is the field MSB
+//
+MAX30102_STATUS Max30102_WriteRegisterField(uint8_t Register, uint8_t Bit, uint8_t Length, uint8_t Value)
+{
+	uint8_t tmp, old;
+	const uint8_t shift = Bit - Length + 1;
+	const uint8_t mask = ((1 << Length) - 1) << shift;
+
+	if(MAX30102_OK != Max30102_ReadRegShadow(Register, &old))
+		return MAX30102_ERROR;
+	tmp = (old & ~mask) | ((Value << shift) & mask);
+	if(tmp == old && RegShadowValid && Max30102_IsRegShadowed(Register))
+		return MAX30102_OK;
 	if(MAX30102_OK != Max30102_WriteReg(Register, tmp))
 		return MAX30102_ERROR;
 
 	return MAX30102_OK;
 }
 
+MAX30102_STATUS Max30102_WriteRegisterBit(uint8_t Register, uint8_t Bit, uint8_t Value)
+{
+	return Max30102_WriteRegisterField(Register, Bit, 1, Value & 0x01);
+}
+
 //
 //	Interrupts
 //
@@ -179,16 +317,7 @@ MAX30102_STATUS Max30102_FifoReadPointer(uint8_t Address)
 
 MAX30102_STATUS Max30102_FifoSampleAveraging(uint8_t Value)
 {
-	uint8_t tmp;
-	if(MAX30102_OK != Max30102_ReadReg(REG_FIFO_CONFIG, &tmp))
-		return MAX30102_ERROR;
-	// again magic
-	tmp &= ~(0x07);
-	tmp |= (Value&0x07)<<5;
-	if(MAX30102_OK != Max30102_WriteReg(REG_FIFO_CONFIG, tmp))
-		return MAX30102_ERROR;
-
-	return MAX30102_OK;
+	return Max30102_WriteRegisterField(REG_FIFO_CONFIG, FIFO_CONF_SMP_AVE_BIT, FIFO_CONF_SMP_AVE_LENGHT, Value);
 }
 
 MAX30102_STATUS Max30102_FifoRolloverEnable(uint8_t Enable)
@@ -202,15 +331,7 @@ MAX30102_STATUS Max30102_FifoAlmostFullValue(uint8_t Value)
 	if(Value < 17) Value = 17;
 	if(Value > 32) Value = 32;
 	Value = 32 - Value;
-	uint8_t tmp;
-	if(MAX30102_OK != Max30102_ReadReg(REG_FIFO_CONFIG, &tmp))
-		return MAX30102_ERROR;
-	tmp &= ~(0x0F);
-	tmp |= (Value & 0x0F);
-	if(MAX30102_OK != Max30102_WriteReg(REG_FIFO_CONFIG, tmp))
-		return MAX30102_ERROR;
-
-	return MAX30102_OK;
+	return Max30102_WriteRegisterField(REG_FIFO_CONFIG, FIFO_CONF_FIFO_A_FULL_BIT, FIFO_CONF_FIFO_A_FULL_LENGHT, Value);
 }
 //
 //	Mode Configuration
@@ -231,61 +352,30 @@ MAX30102_STATUS Max30102_Reset(void)
     		return MAX30102_ERROR;
     } while(tmp & (1<<6));
 
-    return MAX30102_OK;
+    // every register is back to its power-on value
+    return Max30102_SyncRegShadow();
 }
 
 MAX30102_STATUS Max30102_SetMode(uint8_t Mode)
 {
-	uint8_t tmp;
-	if(MAX30102_OK != Max30102_ReadReg(REG_MODE_CONFIG, &tmp))
-		return MAX30102_ERROR;
-	tmp &= ~(0x07);
-	tmp |= (Mode & 0x07);
-	if(MAX30102_OK != Max30102_WriteReg(REG_MODE_CONFIG, tmp))
-		return MAX30102_ERROR;
-
-	return MAX30102_OK;
+	return Max30102_WriteRegisterField(REG_MODE_CONFIG, MODE_MODE_BIT, MODE_MODE_LENGTH, Mode);
 }
 //
 //	SpO2 Configuration
 //
 MAX30102_STATUS Max30102_SpO2AdcRange(uint8_t Value)
 {
-	uint8_t tmp;
-	if(MAX30102_OK != Max30102_ReadReg(REG_SPO2_CONFIG, &tmp))
-		return MAX30102_ERROR;
-	tmp &= ~(0x03);
-	tmp |= ((Value & 0x03) << 5);
-	if(MAX30102_OK != Max30102_WriteReg(REG_SPO2_CONFIG, tmp))
-		return MAX30102_ERROR;
-
-	return MAX30102_OK;
+	return Max30102_WriteRegisterField(REG_SPO2_CONFIG, SPO2_CONF_ADC_RGE_BIT, SPO2_CONF_ADC_RGE_LENGTH, Value);
 }
 
 MAX30102_STATUS Max30102_SpO2SampleRate(uint8_t Value)
 {
-	uint8_t tmp;
-	if(MAX30102_OK != Max30102_ReadReg(REG_SPO2_CONFIG, &tmp))
-		return MAX30102_ERROR;
-	tmp &= ~(0x07);
-	tmp |= ((Value & 0x07) << 2);
-	if(MAX30102_OK != Max30102_WriteReg(REG_SPO2_CONFIG, tmp))
-		return MAX30102_ERROR;
-
-	return MAX30102_OK;
+	return Max30102_WriteRegisterField(REG_SPO2_CONFIG, SPO2_CONF_SR_BIT, SPO2_CONF_SR_LENGTH, Value);
 }
 
 MAX30102_STATUS Max30102_SpO2LedPulseWidth(uint8_t Value)
 {
-	uint8_t tmp;
-	if(MAX30102_OK != Max30102_ReadReg(REG_SPO2_CONFIG, &tmp))
-		return MAX30102_ERROR;
-	tmp &= ~(0x03);
-	tmp |= (Value & 0x03);
-	if(MAX30102_OK != Max30102_WriteReg(REG_SPO2_CONFIG, tmp))
-		return MAX30102_ERROR;
-
-	return MAX30102_OK;
+	return Max30102_WriteRegisterField(REG_SPO2_CONFIG, SPO2_CONF_LED_PW_BIT, SPO2_CONF_LED_PW_LENGTH, Value);
 }
 
 //
@@ -294,16 +384,13 @@ MAX30102_STATUS Max30102_SpO2LedPulseWidth(uint8_t Value)
 //
 MAX30102_STATUS Max30102_Led1PulseAmplitude(uint8_t Value)
 {
-	if(MAX30102_OK != Max30102_WriteReg(REG_LED1_PA, Value))
-		return MAX30102_ERROR;
-	return MAX30102_OK;
+	// whole register field - skipped when current already matches
+	return Max30102_WriteRegisterField(REG_LED1_PA, 7, 8, Value);
 }
 
 MAX30102_STATUS Max30102_Led2PulseAmplitude(uint8_t Value)
 {
-	if(MAX30102_OK != Max30102_WriteReg(REG_LED2_PA, Value))
-		return MAX30102_ERROR;
-	return MAX30102_OK;
+	return Max30102_WriteRegisterField(REG_LED2_PA, 7, 8, Value);
 }
 
 //
@@ -325,55 +412,35 @@ void Max30102_Task(void)
 	switch(StateMachine)
 	{
 		case MAX30102_STATE_BEGIN:
+			// nothing is analysed without finger, drop it before the short ring overruns
+			read_ox_buffer.clear();
 			if(IsFingerOnScreen)
 			{
+				hr_engine.reset();
+#ifdef MAX30102_USE_BANDPASS
+				// LED current step below, filter restarts from the level of the next sample
+				RestartBandpass = true;
+#endif
 				CollectedSamples = 0;
 				Max30102_Led1PulseAmplitude(MAX30102_RED_LED_CURRENT_HIGH);
 				Max30102_Led2PulseAmplitude(MAX30102_IR_LED_CURRENT_HIGH);
-				StateMachine = MAX30102_STATE_CALIBRATE;
+				StateMachine = MAX30102_STATE_MEASURE;
 			}
 		break;
 
-		case MAX30102_STATE_CALIBRATE:
-				if(IsFingerOnScreen)
-				{
-					if(CollectedSamples > (MAX30102_BUFFER_LENGTH-MAX30102_SAMPLES_PER_SECOND))
-					{
-						StateMachine = MAX30102_STATE_CALCULATE_HR;
-					}
-				}
-				else led_low_startover();
-
-		break;
-
-		case MAX30102_STATE_CALCULATE_HR:
+		// every sample goes straight through the HR engine, the sliding one refreshes HR every hop,
+		// the streaming one on every beat
+		case MAX30102_STATE_MEASURE:
 			if(IsFingerOnScreen)
 			{
-				taskDISABLE_INTERRUPTS();
-
-				write_ox_stream.clear();
-
-				for (auto it = read_ox_buffer.begin(); it != read_ox_buffer.end(); it++){
-					write_ox_stream.append(*it);
-				}
-				read_ox_buffer.clear();
-				hr_algo.process(write_ox_stream);
-				HR = hr_algo.get_hr();
-
-				taskENABLE_INTERRUPTS();
-				CollectedSamples = 0;
-				StateMachine = MAX30102_STATE_COLLECT_NEXT_PORTION;
-			}
-			else led_low_startover();
-
-		break;
-
-		case MAX30102_STATE_COLLECT_NEXT_PORTION:
-			if(IsFingerOnScreen)
-			{
-				if(CollectedSamples > MAX30102_SAMPLES_PER_SECOND)
-				{
-					StateMachine = MAX30102_STATE_CALCULATE_HR;
+				TimestampedOxSample sample;
+				while(read_ox_buffer.pop(sample)){
+					if(hr_engine.push(sample))
+					{
+						HR = hr_engine.get_hr();
+						TRACE("hr: %u bpm at %d ms, %u ring overruns", HR, sample.ts, read_ox_buffer.overruns());
+						telemetry::send_heart_rate(sample.ts, HR, IsFingerOnScreen);
+					}
 				}
 			}
 			else led_low_startover();
@@ -382,15 +449,10 @@ void Max30102_Task(void)
 	}
 }
 
-MAX30102_STATUS Max30102_ReadFifo()
+static TimestampedOxSample Max30102_UnpackSample(const uint8_t *ach_i2c_data, int32_t ts)
 {
 	uint32_t un_temp, temp_ir, temp_red;
-	uint8_t ach_i2c_data[6];
 
-	if(HAL_I2C_Mem_Read(i2c_max30102, MAX30102_ADDRESS, REG_FIFO_DATA, 1, ach_i2c_data, 6, I2C_TIMEOUT) != HAL_OK)
-	{
-		return MAX30102_ERROR;
-	}
 	un_temp=(unsigned char) ach_i2c_data[0];
 	un_temp<<=16;
 	temp_red=un_temp;
@@ -412,13 +474,184 @@ MAX30102_STATUS Max30102_ReadFifo()
 	temp_red&=0x03FFFF;  //Mask MSB [23:18]
 	temp_ir&=0x03FFFF;  //Mask MSB [23:18]
 
-	auto const ts = static_cast<uint32_t>(xTaskGetTickCount());
-	last_sample = {ts, temp_ir, temp_red};
-	read_ox_buffer.push(last_sample);
+	return {ts, static_cast<int32_t>(temp_ir), static_cast<int32_t>(temp_red)};
+}
+
+static void Max30102_CollectSample(const TimestampedOxSample& sample)
+{
+	last_sample = sample;
+#ifdef MAX30102_USE_BANDPASS
+	// finger detection and telemetry keep the raw levels, only the HR ring is filtered
+	if(RestartBandpass)
+	{
+		RestartBandpass = false;
+		ox_bandpass.reset();
+	}
+	read_ox_buffer.push(ox_bandpass.process(sample));
+#else
+	read_ox_buffer.push(sample);
+#endif
+	telemetry::push_sample(sample);
+
+	if(IsFingerOnScreen)
+	{
+		if(sample.ir < MAX30102_IR_VALUE_FINGER_OUT_SENSOR) IsFingerOnScreen = 0;
+	}
+	else
+	{
+		if(sample.ir > MAX30102_IR_VALUE_FINGER_ON_SENSOR) IsFingerOnScreen = 1;
+	}
+
+	CollectedSamples++;
+}
+
+MAX30102_STATUS Max30102_ReadFifo()
+{
+	uint8_t ach_i2c_data[MAX30102_FIFO_SAMPLE_BYTES];
+
+	Max30102_LockBus();
+	auto const status = HAL_I2C_Mem_Read(i2c_max30102, MAX30102_ADDRESS, REG_FIFO_DATA, 1, ach_i2c_data, MAX30102_FIFO_SAMPLE_BYTES, I2C_TIMEOUT);
+	Max30102_UnlockBus();
+	if(status != HAL_OK)
+	{
+		return MAX30102_ERROR;
+	}
+
+	auto const ts = static_cast<int32_t>(xTaskGetTickCount());
+	Max30102_CollectSample(Max30102_UnpackSample(ach_i2c_data, ts));
+
+	return MAX30102_OK;
+}
+
+//
+//	Number of samples waiting in FIFO. WR_PTR, OVF_COUNTER and RD_PTR are
+//	consecutive registers, so all three come in a single transaction.
+//
+MAX30102_STATUS Max30102_FifoPendingSamples(uint8_t *Count)
+{
+	uint8_t ach_ptr[3];
+
+	Max30102_LockBus();
+	auto const status = HAL_I2C_Mem_Read(i2c_max30102, MAX30102_ADDRESS, REG_FIFO_WR_PTR, 1, ach_ptr, 3, I2C_TIMEOUT);
+	Max30102_UnlockBus();
+	if(status != HAL_OK)
+		return MAX30102_ERROR;
+
+	const uint8_t wr_ptr = ach_ptr[0] & 0x1F;
+	const uint8_t ovf_counter = ach_ptr[1] & 0x1F;
+	const uint8_t rd_ptr = ach_ptr[2] & 0x1F;
+
+	*Count = (wr_ptr - rd_ptr) & 0x1F;
+	// equal pointers with overflow counter set means full FIFO, not empty one
+	if(*Count == 0 && ovf_counter != 0) *Count = MAX30102_FIFO_DEPTH;
+
+	return MAX30102_OK;
+}
+
+//
+//	Samples are timestamped backwards from now with sample period spacing.
+//
+static void Max30102_UnpackBurst(uint8_t Samples, int32_t now)
+{
+	for(uint8_t i = 0; i < Samples; i++)
+	{
+		auto const ts = now - static_cast<int32_t>(((Samples - 1 - i) * 1000) / MAX30102_SAMPLES_PER_SECOND);
+		Max30102_CollectSample(Max30102_UnpackSample(&FifoBurstData[i * MAX30102_FIFO_SAMPLE_BYTES], ts));
+	}
+}
+
+//
+//	A timed out DMA read leaves the handle busy in memory mode, where
+//	HAL_I2C_Master_Abort_IT does nothing and every later call returns HAL_BUSY.
+//	Stop the RX stream and start the peripheral over instead.
+//
+static void Max30102_RecoverBus(void)
+{
+	HAL_DMA_Abort(i2c_max30102->hdmarx);
+	HAL_I2C_DeInit(i2c_max30102);
+	HAL_I2C_Init(i2c_max30102);
+	TRACE("fifo: dma timeout, i2c reinitialised");
+}
+
+//
+//	Reads Samples from FIFO in one I2C transaction. FIFO_DATA does not
+//	auto-increment register address, so every byte comes from the FIFO.
+//	In DMA mode the calling task blocks until the completion callback
+//	signals the end of transfer, so the core is free while the bus moves data.
+//
+MAX30102_STATUS Max30102_ReadFifoBurst(uint8_t Samples)
+{
+	HAL_StatusTypeDef status;
+
+	if(Samples == 0) return MAX30102_OK;
+	if(Samples > MAX30102_FIFO_DEPTH) Samples = MAX30102_FIFO_DEPTH;
+
+	Max30102_LockBus();
+	if(AcquisitionMode == MAX30102_ACQUISITION_DMA)
+	{
+		FifoDmaError = 0;
+		// a completion that came after the last timeout must not end this transfer
+		xSemaphoreTake(FifoDmaDone, 0);
+		status = HAL_I2C_Mem_Read_DMA(i2c_max30102, MAX30102_ADDRESS, REG_FIFO_DATA, 1, FifoBurstData, Samples * MAX30102_FIFO_SAMPLE_BYTES);
+		if(status == HAL_OK)
+		{
+			if(pdTRUE != xSemaphoreTake(FifoDmaDone, pdMS_TO_TICKS(I2C_TIMEOUT)))
+			{
+				Max30102_RecoverBus();
+				status = HAL_TIMEOUT;
+			}
+			else if(FifoDmaError)
+			{
+				status = HAL_ERROR;
+			}
+		}
+	}
+	else
+	{
+		status = HAL_I2C_Mem_Read(i2c_max30102, MAX30102_ADDRESS, REG_FIFO_DATA, 1, FifoBurstData, Samples * MAX30102_FIFO_SAMPLE_BYTES, I2C_TIMEOUT);
+	}
+	Max30102_UnlockBus();
+
+	if(status != HAL_OK)
+	{
+		return MAX30102_ERROR;
+	}
+
+	Max30102_UnpackBurst(Samples, static_cast<int32_t>(xTaskGetTickCount()));
+
+	return MAX30102_OK;
+}
+
+MAX30102_STATUS Max30102_SetAcquisitionMode(MAX30102_ACQUISITION_MODE Mode)
+{
+	// DMA needs the RX stream linked to I2C handle in HAL_I2C_MspInit
+	if(Mode == MAX30102_ACQUISITION_DMA && (i2c_max30102->hdmarx == NULL || FifoDmaDone == NULL))
+		return MAX30102_ERROR;
 
+	Max30102_LockBus();
+	AcquisitionMode = Mode;
+	Max30102_UnlockBus();
 	return MAX30102_OK;
 }
 
+//
+//	Called from I2C DMA/IRQ context, only wakes up the task waiting in Max30102_ReadFifoBurst
+//
+void Max30102_FifoDmaCompleteCallback(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	xSemaphoreGiveFromISR(FifoDmaDone, &xHigherPriorityTaskWoken);
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void Max30102_FifoDmaErrorCallback(void)
+{
+	// samples stay in FIFO, next PPG_RDY interrupt picks them up
+	FifoDmaError = 1;
+	TRACE("fifo: dma error, i2c error code 0x%x", i2c_max30102->ErrorCode);
+	Max30102_FifoDmaCompleteCallback();
+}
+
 MAX30102_STATUS Max30102_ReadInterruptStatus(uint8_t *Status)
 {
 	uint8_t tmp;
@@ -435,35 +668,47 @@ MAX30102_STATUS Max30102_ReadInterruptStatus(uint8_t *Status)
 	return MAX30102_OK;
 }
 
-void collect_fifo() {
-	while(MAX30102_OK != Max30102_ReadFifo()); // read 2 words
-	const auto ir = read_ox_buffer.back().ir;
-	if(IsFingerOnScreen)
-	{
-		if(ir < MAX30102_IR_VALUE_FINGER_OUT_SENSOR) IsFingerOnScreen = 0;
-	}
-	else
-	{
-		if(ir > MAX30102_IR_VALUE_FINGER_ON_SENSOR) IsFingerOnScreen = 1;
-	}
-
-	CollectedSamples++;
+MAX30102_STATUS collect_fifo() {
+	PROFILE_SCOPE(CollectFifo);
+	uint8_t pending;
+	if(MAX30102_OK != Max30102_FifoPendingSamples(&pending))
+		return MAX30102_ERROR;
+	TRACE("fifo: %u samples pending", pending);
+	return Max30102_ReadFifoBurst(pending);
 }
 
-void Max30102_InterruptCallback(void)
+//
+//	Sensor interrupt handler, runs in acquisition task context after EXTI notification.
+//	Gives up after I2C_RETRIES failed reads, the caller decides when to try again.
+//
+MAX30102_STATUS Max30102_InterruptCallback(void)
 {
+	PROFILE_SCOPE(Max30102Interrupt);
 	uint8_t Status;
+	uint8_t Retries{0};
 	// TODO: omin bledna paczke
-	while(MAX30102_OK != Max30102_ReadInterruptStatus(&Status));
-
-	// Almost Full FIFO Interrupt handle
-	if(Status & (1<<INT_A_FULL_BIT))
+	while(MAX30102_OK != Max30102_ReadInterruptStatus(&Status))
 	{
-		for(uint8_t i = 0; i < MAX30102_FIFO_ALMOST_FULL_SAMPLES; i++) collect_fifo();
+		if(++Retries == I2C_RETRIES)
+		{
+			TRACE("int: status read failed %u times", Retries);
+			return MAX30102_ERROR;
+		}
 	}
 
-	// New FIFO Data Ready Interrupt handle
-	if(Status & (1<<INT_PPG_RDY_BIT)) collect_fifo();
+	// Almost Full FIFO and New FIFO Data Ready Interrupts handle - drain everything pending at once
+	if(Status & ((1<<INT_A_FULL_BIT) | (1<<INT_PPG_RDY_BIT)))
+	{
+		Retries = 0;
+		while(MAX30102_OK != collect_fifo())
+		{
+			if(++Retries == I2C_RETRIES)
+			{
+				TRACE("fifo: burst read failed %u times", Retries);
+				return MAX30102_ERROR;
+			}
+		}
+	}
 
 //	//  Ambient Light Cancellation Overflow Interrupt handle
 //	if(Status & (1<<INT_ALC_OVF_BIT)){};
@@ -475,6 +720,7 @@ void Max30102_InterruptCallback(void)
 	// Internal Temperature Ready Interrupt handle
 	if(Status & (1<<INT_DIE_TEMP_RDY_BIT)){};
 #endif
+	return MAX30102_OK;
 }
 
 //
@@ -484,6 +730,12 @@ MAX30102_STATUS Max30102_Init(I2C_HandleTypeDef *i2c)
 {
 	uint8_t uch_dummy;
 	i2c_max30102 = i2c;
+	if(I2cBusMutex == NULL)
+		I2cBusMutex = xSemaphoreCreateMutex();
+	if(FifoDmaDone == NULL)
+		FifoDmaDone = xSemaphoreCreateBinary();
+	if(I2cBusMutex == NULL)
+		return MAX30102_ERROR;
 	if(MAX30102_OK != Max30102_Reset()) //resets the MAX30102
 		return MAX30102_ERROR;
 	if(MAX30102_OK != Max30102_ReadReg(0,&uch_dummy))
@@ -518,8 +770,13 @@ MAX30102_STATUS Max30102_Init(I2C_HandleTypeDef *i2c)
 		return MAX30102_ERROR;
 //	if(MAX30102_OK != Max30102_WriteReg(REG_PILOT_PA,0x7f))   // Choose value for ~ 25mA for Pilot LED
 //		return MAX30102_ERROR;
+	// fall back to blocking reads when I2C has no DMA stream attached
+	if(MAX30102_OK != Max30102_SetAcquisitionMode(MAX30102_ACQUISITION_DMA))
+		Max30102_SetAcquisitionMode(MAX30102_ACQUISITION_BLOCKING);
 	StateMachine = MAX30102_STATE_BEGIN;
 	return MAX30102_OK;
 }
 
-float get_hr(){ return hr_algo.get_hr(); }
+uint32_t get_hr(){ return HR; }
+
+uint32_t Max30102_RingOverruns(void){ return read_ox_buffer.overruns(); }
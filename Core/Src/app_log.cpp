@@ -0,0 +1,121 @@
+/*
+ * app_log.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include "app_log.h"
+#include "log_ring.hpp"
+#include "trace.hpp"
+#include "telemetry.hpp"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#if defined(__arm__)
+#include "stm32f4xx.h"
+#endif
+
+static LogRing<APP_LOG_BUFFER_CELLS> log_ring{};
+
+static TaskHandle_t log_drain_task_handle;
+static void log_drain_task_handler(void* params);
+
+#if defined(__arm__)
+// ITM is enabled by the debugger (SWV), without it output is dropped instead of waiting forever
+static bool itm_ready(void)
+{
+	return (ITM->TCR & ITM_TCR_ITMENA_Msk) != 0 && (ITM->TER & 1UL) != 0;
+}
+#endif
+
+static void log_output(uint32_t word, uint8_t len)
+{
+#if defined(__arm__)
+	if (!itm_ready()) return;
+	if (len == LogRing<APP_LOG_BUFFER_CELLS>::CELL_BYTES){
+		while (ITM->PORT[0].u32 == 0UL) __NOP();
+		ITM->PORT[0].u32 = word;
+		return;
+	}
+	for (uint8_t i{0}; i < len; i++){
+		while (ITM->PORT[0].u32 == 0UL) __NOP();
+		ITM->PORT[0].u8 = static_cast<uint8_t>(word >> (8 * i));
+	}
+#else
+	fwrite(&word, 1, len, stdout);
+#endif
+}
+
+void App_LogCreateTask(void)
+{
+#if defined(__arm__)
+	// what ITM_SendChar in syscalls.c did on every character
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	ITM->TER |= 1UL;
+	// port 1 - binary trace records, port 2 - telemetry frames
+	ITM->TER |= 2UL | 4UL;
+#endif
+	auto const status = xTaskCreate(log_drain_task_handler, "log_drain", 256, NULL, 1, &log_drain_task_handle);
+	configASSERT(status == pdPASS);
+}
+
+int App_LogWrite(const char *data, int len)
+{
+	if (len <= 0) return 0;
+	return log_ring.write(data, static_cast<size_t>(len)) ? len : 0;
+}
+
+int App_LogPrintf(const char *format, ...)
+{
+	char line[APP_LOG_LINE_LENGTH];
+	va_list args;
+	va_start(args, format);
+	int len = vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+
+	if (len < 0) return len;
+	if (len >= static_cast<int>(sizeof(line))) len = sizeof(line) - 1;
+	return App_LogWrite(line, len);
+}
+
+void App_LogDrain(void)
+{
+	uint32_t word;
+	uint8_t len;
+	while (log_ring.read(word, len)) log_output(word, len);
+#if !defined(__arm__)
+	fflush(stdout);
+#endif
+}
+
+uint32_t App_LogDropped(void)
+{
+	return log_ring.dropped();
+}
+
+static void log_drain_task_handler(void* params){
+	(void)params;
+
+	while(1){
+		App_LogDrain();
+		trace::drain();
+		telemetry::drain();
+		vTaskDelay(pdMS_TO_TICKS(APP_LOG_DRAIN_PERIOD_MS));
+	}
+}
+
+#if defined(__arm__)
+// replaces the weak one in syscalls.c - printf output is queued, not sent byte by byte
+extern "C" int _write(int file, char *ptr, int len)
+{
+	(void)file;
+	App_LogWrite(ptr, len);
+	// dropped output is counted, reporting it as written keeps newlib from retrying
+	return len;
+}
+#endif
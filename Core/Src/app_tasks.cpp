@@ -0,0 +1,96 @@
+/*
+ * app_tasks.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include "main.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "app_tasks.h"
+#include "task_stats.h"
+#include "app_log.h"
+
+static void db_led_task_handler(void* params);
+TaskHandle_t db_led_task_handle;
+static void max30102_task_handler(void* params);
+TaskHandle_t max30102_task_handle;
+static void max30102_acq_task_handler(void* params);
+TaskHandle_t max30102_acq_task_handle;
+//static void max30102_print_task_handler(void* params);
+//TaskHandle_t max30102_print_task_handle;
+
+void App_CreateTasks(void)
+{
+	configASSERT(xTaskCreate(db_led_task_handler, "debug_led_task", 200, NULL, 3, &db_led_task_handle) == pdPASS);
+	auto status = xTaskCreate(max30102_task_handler, "max30102_task", 5000, NULL, 2, &max30102_task_handle);
+	configASSERT(status == pdPASS);
+	status = xTaskCreate(max30102_acq_task_handler, "max30102_acq", 512, NULL, 4, &max30102_acq_task_handle);
+	configASSERT(status == pdPASS);
+	TaskStats_CreateTask();
+	App_LogCreateTask();
+}
+
+static void db_led_task_handler(void* params){
+	(void)params;
+
+	while(1){
+		HAL_GPIO_TogglePin(DB_LED_GPIO_Port, DB_LED_Pin);
+		vTaskDelay(500);
+	}
+}
+
+static void max30102_task_handler(void* params){
+	(void)params;
+	while(1){
+		Max30102_Task();
+		App_LogPrintf("%u\n", static_cast<unsigned>(get_hr()));
+
+		// with 10 ms system crashes - needs testing
+		vTaskDelay(50);
+	}
+}
+
+// Owns the sensor - initializes it and drains FIFO whenever EXTI signals an interrupt
+static void max30102_acq_task_handler(void* params){
+	(void)params;
+	auto const status = Max30102_Init(&hi2c1);
+	configASSERT(status == MAX30102_OK);
+
+	while(1){
+		// INT line stays low until status is read, so no edge comes after init
+		// or after a failed read. Retry on a delay to let lower priority tasks run.
+		while(MAX30102_OK != Max30102_InterruptCallback())
+			vTaskDelay(pdMS_TO_TICKS(10));
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	}
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	if (GPIO_Pin == MAX_INT_Pin)
+	{
+		if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) return;
+
+		BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+		vTaskNotifyGiveFromISR(max30102_acq_task_handle, &xHigherPriorityTaskWoken);
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+	}
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	if (hi2c->Instance == I2C1)
+	{
+		Max30102_FifoDmaCompleteCallback();
+	}
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	if (hi2c->Instance == I2C1)
+	{
+		Max30102_FifoDmaErrorCallback();
+	}
+}
@@ -19,16 +19,19 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "dma.h"
 #include "gpio.h"
 #include "i2c.h"
+#include "tim.h"
+#include "usart.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "FreeRTOS.h"
 #include "FreeRTOSConfig.h"
 #include "task.h"
 
-
-#include "stdio.h"
+#include "app_tasks.h"
+#include "profiler.hpp"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -54,14 +57,6 @@
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
-static void db_led_task_handler(void* params);
-TaskHandle_t db_led_task_handle;
-static void max30102_task_handler(void* params);
-TaskHandle_t max30102_task_handle;
-//static void max30102_print_task_handler(void* params);
-//TaskHandle_t max30102_print_task_handle;
-
-extern I2C_HandleTypeDef hi2c1;
 
 /* USER CODE END PFP */
 
@@ -97,11 +92,13 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_I2C1_Init();
+  MX_TIM2_Init();
+  MX_USART1_UART_Init();
   /* USER CODE BEGIN 2 */
-  configASSERT(xTaskCreate(db_led_task_handler, "debug_led_task", 200, NULL, 3, &db_led_task_handle) == pdPASS);
-  auto const status = xTaskCreate(max30102_task_handler, "max30102_task", 5000, NULL, 2, &max30102_task_handle);
-  configASSERT(status == pdPASS);
+  profiler::init();
+  App_CreateTasks();
 
   vTaskStartScheduler();
   /* USER CODE END 2 */
@@ -163,35 +160,6 @@ void SystemClock_Config(void)
 
 /* USER CODE BEGIN 4 */
 
-static void db_led_task_handler(void* params){
-
-	while(1){
-		HAL_GPIO_TogglePin(DB_LED_GPIO_Port, DB_LED_Pin);
-		vTaskDelay(500);
-	}
-}
-
-static void max30102_task_handler(void* params){
-	auto const status = Max30102_Init(&hi2c1);
-	configASSERT(status == MAX30102_OK);
-
-	while(1){
-		Max30102_Task();
-		printf("%d\n", int(get_hr()));
-
-		// with 10 ms system crashes - needs testing
-		vTaskDelay(50);
-	}
-}
-
-void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
-{
-	if (GPIO_Pin == MAX_INT_Pin)
-	{
-		Max30102_InterruptCallback();
-	}
-}
-
 /* USER CODE END 4 */
 
 /**
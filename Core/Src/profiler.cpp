@@ -0,0 +1,67 @@
+/*
+ * profiler.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include "profiler.hpp"
+
+namespace profiler {
+
+	SiteStats table[static_cast<size_t>(Site::Count)]{};
+
+	static const char* const SITE_NAMES[] = {
+		"Max30102_InterruptCallback",
+		"collect_fifo",
+		"HeartRate::process",
+		"  smoothed_gradient",
+		"  hr_calculator",
+		"StreamingHeartRate::push",
+		"SlidingHeartRate hop",
+	};
+	static_assert(sizeof(SITE_NAMES) / sizeof(SITE_NAMES[0]) == static_cast<size_t>(Site::Count), "every site needs a name");
+
+#if defined(__arm__)
+	static const char* const UNIT = "cycles";
+#else
+	static const char* const UNIT = "ns";
+#endif
+
+	void init(void){
+#if defined(__arm__)
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+		reset();
+	}
+
+	void reset(void){
+		for (auto& s : table) s = SiteStats{};
+	}
+
+	// one call per line, each fits in APP_LOG_LINE_LENGTH
+	template<typename Print>
+	static void dump_lines(Print print){
+		print("%-28s %10s %10s %10s %10s  [%s]\n", "site", "count", "min", "mean", "max", UNIT);
+		for (size_t i{0}; i < static_cast<size_t>(Site::Count); i++){
+			const SiteStats s = table[i];
+			if (s.count == 0) continue;
+			print("%-28s %10lu %10lu %10lu %10lu\n", SITE_NAMES[i],
+					static_cast<unsigned long>(s.count),
+					static_cast<unsigned long>(s.min),
+					static_cast<unsigned long>(s.total / s.count),
+					static_cast<unsigned long>(s.max));
+		}
+	}
+
+	void dump(FILE* out){
+		dump_lines([out](const char* format, auto... args){ fprintf(out, format, args...); });
+	}
+
+	void dump(int (*print)(const char* format, ...)){
+		dump_lines(print);
+	}
+
+}
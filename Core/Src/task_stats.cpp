@@ -0,0 +1,79 @@
+/*
+ * task_stats.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include "main.h"
+#include "task_stats.h"
+#include "app_log.h"
+#include "trace.hpp"
+#include "telemetry.hpp"
+#include "profiler.hpp"
+
+TaskHandle_t task_stats_task_handle;
+static void task_stats_task_handler(void* params);
+
+// previous snapshot, load is reported over the last period and not since boot
+static TaskStatus_t previous[TASK_STATS_MAX_TASKS];
+static UBaseType_t previous_count{0};
+static uint32_t previous_total{0};
+
+void TaskStats_CreateTask(void)
+{
+	auto const status = xTaskCreate(task_stats_task_handler, "stats_task", 384, NULL, 1, &task_stats_task_handle);
+	configASSERT(status == pdPASS);
+}
+
+static uint32_t previous_runtime(UBaseType_t task_number)
+{
+	for (UBaseType_t i{0}; i < previous_count; i++){
+		if (previous[i].xTaskNumber == task_number) return previous[i].ulRunTimeCounter;
+	}
+	return 0;
+}
+
+void TaskStats_Report(void)
+{
+	static TaskStatus_t current[TASK_STATS_MAX_TASKS];
+	uint32_t total{0};
+
+	const UBaseType_t count = uxTaskGetSystemState(current, TASK_STATS_MAX_TASKS, &total);
+	// 0 means the array is too small for all tasks
+	configASSERT(count != 0);
+
+	// counters are 32 bit, unsigned differences survive one wrap
+	const uint32_t elapsed = total - previous_total;
+
+	App_LogPrintf("task             cpu%%   free stack [words], log dropped %lu\n", static_cast<unsigned long>(App_LogDropped()));
+	for (UBaseType_t i{0}; i < count; i++){
+		const auto& task = current[i];
+		const uint32_t busy = task.ulRunTimeCounter - previous_runtime(task.xTaskNumber);
+		const uint32_t permille = elapsed ? static_cast<uint32_t>((static_cast<uint64_t>(busy) * 1000) / elapsed) : 0;
+		App_LogPrintf("%-16s %3lu.%lu %6u\n", task.pcTaskName,
+				static_cast<unsigned long>(permille / 10), static_cast<unsigned long>(permille % 10),
+				static_cast<unsigned>(task.usStackHighWaterMark));
+	}
+
+	// both tables together overflow the log ring, let log_drain empty it in between
+	vTaskDelay(pdMS_TO_TICKS(2 * APP_LOG_DRAIN_PERIOD_MS));
+	profiler::dump(App_LogPrintf);
+
+	telemetry::send_diagnostics(static_cast<int32_t>(xTaskGetTickCount()),
+			{Max30102_RingOverruns(), App_LogDropped(), trace::dropped(), telemetry::dropped()});
+
+	for (UBaseType_t i{0}; i < count; i++) previous[i] = current[i];
+	previous_count = count;
+	previous_total = total;
+}
+
+static void task_stats_task_handler(void* params){
+	(void)params;
+	TickType_t last_wake = xTaskGetTickCount();
+
+	while(1){
+		vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(TASK_STATS_PERIOD_MS));
+		TaskStats_Report();
+	}
+}
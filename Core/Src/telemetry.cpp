@@ -0,0 +1,176 @@
+/*
+ * telemetry.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include "telemetry.hpp"
+#include "log_ring.hpp"
+
+#if defined(__arm__)
+#include "uart_transport.hpp"
+#endif
+
+#ifndef TELEMETRY_BUFFER_CELLS
+#define TELEMETRY_BUFFER_CELLS 256
+#endif
+
+namespace telemetry {
+
+	static const constexpr size_t HEADER_BYTES = 3;
+	static const constexpr size_t CRC_BYTES = 2;
+	static const constexpr size_t SAMPLE_BYTES = 7;
+	static const constexpr size_t MAX_BODY = 5 + TELEMETRY_SAMPLES_PER_FRAME * SAMPLE_BYTES;
+	static const constexpr size_t MAX_PAYLOAD = HEADER_BYTES + MAX_BODY + CRC_BYTES;
+	// COBS overhead and the delimiter
+	static const constexpr size_t MAX_FRAME = MAX_PAYLOAD + MAX_PAYLOAD / 254 + 2;
+
+	static_assert(TELEMETRY_SAMPLES_PER_FRAME <= 255, "sample count is a single byte");
+
+	static LogRing<TELEMETRY_BUFFER_CELLS> ring{};
+	static uint16_t sequence[static_cast<size_t>(MessageType::Count)]{};
+
+	// SAMPLES frame being filled by the acquisition task
+	static uint8_t batch[MAX_BODY];
+	static size_t batch_count{0};
+	static int32_t batch_last_ts{0};
+
+#if defined(__arm__)
+#if TELEMETRY_TRANSPORT_UART
+	static Transport* transport{&uart_transport};
+#else
+	static ItmTransport itm_transport{2};
+	static Transport* transport{&itm_transport};
+#endif
+#else
+	static Transport* transport{nullptr};
+#endif
+
+	void set_transport(Transport* out){ transport = out; }
+
+	static uint8_t* put_u16(uint8_t* p, uint16_t v){
+		p[0] = static_cast<uint8_t>(v);
+		p[1] = static_cast<uint8_t>(v >> 8);
+		return p + 2;
+	}
+
+	static uint8_t* put_u24(uint8_t* p, uint32_t v){
+		p[0] = static_cast<uint8_t>(v);
+		p[1] = static_cast<uint8_t>(v >> 8);
+		p[2] = static_cast<uint8_t>(v >> 16);
+		return p + 3;
+	}
+
+	static uint8_t* put_u32(uint8_t* p, uint32_t v){
+		p = put_u16(p, static_cast<uint16_t>(v));
+		return put_u16(p, static_cast<uint16_t>(v >> 16));
+	}
+
+	// nibble table keeps the code and flash small, 2 lookups per byte
+	uint16_t crc16(const uint8_t* data, size_t len){
+		static const uint16_t TABLE[16] = {
+			0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+			0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+		};
+		uint16_t crc{0xFFFF};
+		for (size_t i{0}; i < len; i++){
+			crc = static_cast<uint16_t>((crc << 4) ^ TABLE[(crc >> 12) ^ (data[i] >> 4)]);
+			crc = static_cast<uint16_t>((crc << 4) ^ TABLE[(crc >> 12) ^ (data[i] & 0x0F)]);
+		}
+		return crc;
+	}
+
+	size_t cobs_encode(const uint8_t* data, size_t len, uint8_t* out){
+		size_t code_index{0}, write_index{1};
+		uint8_t code{1};
+		for (size_t i{0}; i < len; i++){
+			if (data[i] != 0){
+				out[write_index++] = data[i];
+				code++;
+			}
+			if (data[i] == 0 || code == 0xFF){
+				out[code_index] = code;
+				code = 1;
+				code_index = write_index++;
+			}
+		}
+		out[code_index] = code;
+		return write_index;
+	}
+
+	static void send(MessageType type, const uint8_t* body, size_t len){
+		uint8_t payload[MAX_PAYLOAD];
+		uint8_t frame[MAX_FRAME];
+
+		uint16_t& seq = sequence[static_cast<size_t>(type)];
+		uint8_t* p = payload;
+		*p++ = static_cast<uint8_t>(type);
+		p = put_u16(p, seq++);
+		for (size_t i{0}; i < len; i++) *p++ = body[i];
+		p = put_u16(p, crc16(payload, static_cast<size_t>(p - payload)));
+
+		size_t frame_len = cobs_encode(payload, static_cast<size_t>(p - payload), frame);
+		frame[frame_len++] = 0x00;
+		ring.write(reinterpret_cast<const char*>(frame), frame_len);
+	}
+
+	void push_sample(const TimestampedOxSample& sample){
+		uint8_t* p = &batch[5 + batch_count * SAMPLE_BYTES];
+		if (batch_count == 0){
+			put_u32(batch, static_cast<uint32_t>(sample.ts));
+			*p++ = 0;
+		} else {
+			const int32_t dt = sample.ts - batch_last_ts;
+			*p++ = static_cast<uint8_t>(dt < 0 ? 0 : (dt > 0xFF ? 0xFF : dt));
+		}
+		p = put_u24(p, static_cast<uint32_t>(sample.ir));
+		put_u24(p, static_cast<uint32_t>(sample.red));
+		batch_last_ts = sample.ts;
+
+		if (++batch_count == TELEMETRY_SAMPLES_PER_FRAME) flush_samples();
+	}
+
+	void flush_samples(void){
+		if (batch_count == 0) return;
+		batch[4] = static_cast<uint8_t>(batch_count);
+		send(MessageType::Samples, batch, 5 + batch_count * SAMPLE_BYTES);
+		batch_count = 0;
+	}
+
+	// integer only, called from Max30102_Task which may run without FPU context
+	void send_heart_rate(int32_t ts, uint32_t bpm, bool finger_on){
+		uint8_t body[7];
+		uint8_t* p = put_u32(body, static_cast<uint32_t>(ts));
+		p = put_u16(p, bpm >= 0xFFFF / 10 ? 0xFFFF : static_cast<uint16_t>(bpm * 10));
+		*p = static_cast<uint8_t>((finger_on ? 1 : 0) | (bpm > 0 ? 2 : 0));
+		send(MessageType::HeartRate, body, sizeof(body));
+	}
+
+	void send_diagnostics(int32_t ts, const Diagnostics& diagnostics){
+		uint8_t body[20];
+		uint8_t* p = put_u32(body, static_cast<uint32_t>(ts));
+		p = put_u32(p, diagnostics.ring_overruns);
+		p = put_u32(p, diagnostics.log_dropped);
+		p = put_u32(p, diagnostics.trace_dropped);
+		put_u32(p, diagnostics.telemetry_dropped);
+		send(MessageType::Diagnostics, body, sizeof(body));
+	}
+
+	// cells stay queued while the transport is full, frames are never cut
+	void drain(void){
+		uint32_t word;
+		uint8_t len;
+		if (transport == nullptr){
+			while (ring.read(word, len)) {}
+			return;
+		}
+		while (transport->writable() >= LogRing<TELEMETRY_BUFFER_CELLS>::CELL_BYTES && ring.read(word, len)){
+			transport->write(reinterpret_cast<const uint8_t*>(&word), len);
+		}
+		transport->flush();
+	}
+
+	uint32_t dropped(void){ return ring.dropped(); }
+
+}
@@ -0,0 +1,55 @@
+/*
+ * trace.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include "trace.hpp"
+#include "log_ring.hpp"
+
+#if defined(__arm__)
+#include "stm32f4xx.h"
+#endif
+
+#ifndef TRACE_BUFFER_WORDS
+#define TRACE_BUFFER_WORDS 256
+#endif
+
+namespace trace {
+
+	static LogRing<TRACE_BUFFER_WORDS> ring{};
+
+#if !defined(__arm__)
+	static FILE* output{nullptr};
+
+	void set_output(FILE* out){ output = out; }
+#endif
+
+	bool write(const uint32_t* words, size_t count){
+		return ring.write(reinterpret_cast<const char*>(words), count * sizeof(uint32_t));
+	}
+
+	// records are whole words, every cell is full
+	void drain(void){
+		uint32_t word;
+		uint8_t len;
+#if defined(__arm__)
+		// ITM port 1 has to be enabled by the debugger next to port 0
+		const bool enabled = (ITM->TCR & ITM_TCR_ITMENA_Msk) != 0 && (ITM->TER & 2UL) != 0;
+		while (ring.read(word, len)){
+			if (!enabled) continue;
+			while (ITM->PORT[1].u32 == 0UL) __NOP();
+			ITM->PORT[1].u32 = word;
+		}
+#else
+		while (ring.read(word, len)){
+			if (output != nullptr) fwrite(&word, 1, len, output);
+		}
+		if (output != nullptr) fflush(output);
+#endif
+	}
+
+	uint32_t dropped(void){ return ring.dropped(); }
+
+}
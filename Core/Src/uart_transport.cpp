@@ -0,0 +1,54 @@
+/*
+ * uart_transport.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include "uart_transport.hpp"
+#include "usart.h"
+
+#include <string.h>
+
+UartTransport uart_transport{};
+
+size_t UartTransport::writable(void) const {
+	return UART_TRANSPORT_BUFFER_BYTES - _len;
+}
+
+size_t UartTransport::write(const uint8_t* data, size_t len){
+	const size_t space = UART_TRANSPORT_BUFFER_BYTES - _len;
+	const size_t count = len < space ? len : space;
+	memcpy(&_buffers[_fill][_len], data, count);
+	_len += count;
+	if (_len == UART_TRANSPORT_BUFFER_BYTES) start();
+	return count;
+}
+
+void UartTransport::flush(void){
+	start();
+}
+
+void UartTransport::tx_complete(void){
+	_busy.store(false, etl::memory_order_release);
+}
+
+// the buffer in flight is never touched until tx_complete() releases it
+void UartTransport::start(void){
+	if (_len == 0 || _busy.load(etl::memory_order_acquire)) return;
+
+	_busy.store(true, etl::memory_order_relaxed);
+	if (!USART1_TransmitDMA(_buffers[_fill], static_cast<uint16_t>(_len))){
+		_busy.store(false, etl::memory_order_relaxed);
+		return;
+	}
+	_transfers++;
+	_bytes_sent += _len;
+	_fill ^= 1;
+	_len = 0;
+}
+
+extern "C" void USART1_TxCompleteCallback(void)
+{
+	uart_transport.tx_complete();
+}
@@ -0,0 +1,122 @@
+/**
+  ******************************************************************************
+  * @file    usart.c
+  * @brief   This file provides code for the configuration
+  *          of the USART instances.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "usart.h"
+
+/* USER CODE BEGIN 0 */
+/*
+ * HAL UART module is not part of this tree (HAL_UART_MODULE_ENABLED is off),
+ * USART1 is set up on registers and only the TX DMA stream goes through HAL.
+ */
+static void USART1_DMA_TxCplt(DMA_HandleTypeDef *hdma);
+static void USART1_DMA_TxError(DMA_HandleTypeDef *hdma);
+/* USER CODE END 0 */
+
+DMA_HandleTypeDef hdma_usart1_tx;
+
+/* USART1 init function */
+void MX_USART1_UART_Init(void)
+{
+
+  /* USER CODE BEGIN USART1_Init 0 */
+
+  /* USER CODE END USART1_Init 0 */
+
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  /* USER CODE BEGIN USART1_Init 1 */
+
+  /* USER CODE END USART1_Init 1 */
+  /* USART1 clock enable */
+  __HAL_RCC_USART1_CLK_ENABLE();
+
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  /**USART1 GPIO Configuration
+  PA9     ------> USART1_TX
+  PA10     ------> USART1_RX
+  */
+  GPIO_InitStruct.Pin = GPIO_PIN_9|GPIO_PIN_10;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF7_USART1;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+  /* USART1 DMA Init */
+  /* USART1_TX Init */
+  hdma_usart1_tx.Instance = DMA2_Stream7;
+  hdma_usart1_tx.Init.Channel = DMA_CHANNEL_4;
+  hdma_usart1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma_usart1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma_usart1_tx.Init.MemInc = DMA_MINC_ENABLE;
+  hdma_usart1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma_usart1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  hdma_usart1_tx.Init.Mode = DMA_NORMAL;
+  hdma_usart1_tx.Init.Priority = DMA_PRIORITY_LOW;
+  hdma_usart1_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+  if (HAL_DMA_Init(&hdma_usart1_tx) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /* USER CODE BEGIN USART1_Init 2 */
+  /* 8N1, oversampling by 16, TX and RX, transmitter fed by DMA */
+  USART1->CR1 = 0;
+  USART1->CR2 = 0;
+  USART1->CR3 = USART_CR3_DMAT;
+  USART1->BRR = (HAL_RCC_GetPCLK2Freq() + USART1_BAUD_RATE / 2U) / USART1_BAUD_RATE;
+  USART1->CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+  hdma_usart1_tx.XferCpltCallback = USART1_DMA_TxCplt;
+  hdma_usart1_tx.XferErrorCallback = USART1_DMA_TxError;
+  /* USER CODE END USART1_Init 2 */
+
+}
+
+/* USER CODE BEGIN 1 */
+
+int USART1_TransmitDMA(const uint8_t *data, uint16_t len)
+{
+  if (HAL_DMA_Start_IT(&hdma_usart1_tx, (uint32_t)data, (uint32_t)&USART1->DR, len) != HAL_OK)
+  {
+    return 0;
+  }
+  return 1;
+}
+
+__weak void USART1_TxCompleteCallback(void)
+{
+}
+
+static void USART1_DMA_TxCplt(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  USART1_TxCompleteCallback();
+}
+
+/* HAL has already disabled the stream on a transfer error, release the buffer so output goes on */
+static void USART1_DMA_TxError(DMA_HandleTypeDef *hdma)
+{
+  (void)hdma;
+  USART1_TxCompleteCallback();
+}
+
+/* USER CODE END 1 */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,187 @@
+/*
+ * hr_accuracy.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Accuracy and throughput of HeartRate recomputed per window, SlidingHeartRate
+ *  and StreamingHeartRate on synthetic PPG with known heart rate, for every
+ *  sample rate MAX30102 supports. "-q" rows run the same engine with
+ *  algo::utils::fixed_math instead of float. "bp-" rows feed the engine
+ *  through the PpgBandpass biquad front end in place of its box smoothing.
+ *  Each HR update is scored against true HR averaged over the last
+ *  MAX30102_MEASUREMENT_SECONDS. Zero HR (not enough peaks) is counted apart
+ *  and left out of the error.
+ *
+ *  usage: hr_accuracy [--seconds N] [--seed N] [--sps N] [--scenario rest|exercise|motion]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "hr_pipeline.hpp"
+#include "ppg_synth.hpp"
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+static const char* const SCENARIOS[] = {"rest", "exercise", "motion"};
+static const constexpr double WITHIN_BPM = 5.0;
+
+struct Options {
+	uint32_t seconds{300};
+	uint64_t seed{1};
+	uint32_t sps{0};		// 0 - all rates
+	const char* scenario{nullptr};	// nullptr - all scenarios
+};
+
+bool parse_options(int argc, char** argv, Options& opt){
+	for (int i{1}; i < argc; i++){
+		if (!strcmp(argv[i], "--seconds") && i + 1 < argc) opt.seconds = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--seed") && i + 1 < argc) opt.seed = strtoull(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--sps") && i + 1 < argc) opt.sps = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--scenario") && i + 1 < argc) opt.scenario = argv[++i];
+		else return false;
+	}
+	return opt.seconds > MAX30102_MEASUREMENT_SECONDS + 1;
+}
+
+struct Signal {
+	std::vector<TimestampedOxSample> samples;
+	std::vector<double> bpm_prefix;		// bpm_prefix[i] - sum of true bpm of samples [0, i)
+};
+
+void generate(const PpgSynthConfig& cfg, uint32_t seconds, Signal& signal){
+	PpgSynth synth{cfg};
+	const size_t count = static_cast<size_t>(seconds) * cfg.sample_rate;
+	signal.samples.resize(count);
+	signal.bpm_prefix.resize(count + 1);
+	signal.bpm_prefix[0] = 0.0;
+	for (size_t i{0}; i < count; i++){
+		const auto s = synth.next();
+		signal.samples[i] = s.sample;
+		signal.bpm_prefix[i + 1] = signal.bpm_prefix[i] + s.true_bpm;
+	}
+}
+
+struct Update {
+	size_t index;
+	uint32_t hr;
+};
+
+struct Score {
+	size_t updates{0};
+	size_t zeros{0};
+	size_t within{0};
+	double abs_error{0.0};
+	double seconds{0.0};
+};
+
+template<typename Engine>
+Score run_engine(const Signal& signal, size_t truth_span){
+	std::unique_ptr<Engine> engine{new Engine{}};
+	std::vector<Update> updates;
+	updates.reserve(signal.samples.size() / 16 + 16);
+
+	const auto start = bench_clock::now();
+	for (size_t i{0}; i < signal.samples.size(); i++){
+		if (engine->push(signal.samples[i])) updates.push_back({i, engine->get_hr()});
+	}
+
+	Score score{};
+	score.seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+	for (const auto& u : updates){
+		score.updates++;
+		if (u.hr == 0){
+			score.zeros++;
+			continue;
+		}
+		const size_t end = u.index + 1;
+		const size_t begin = end > truth_span ? end - truth_span : 0;
+		const double truth = (signal.bpm_prefix[end] - signal.bpm_prefix[begin]) / (end - begin);
+		const double error = fabs(static_cast<double>(u.hr) - truth);
+		score.abs_error += error;
+		if (error <= WITHIN_BPM) score.within++;
+	}
+	return score;
+}
+
+void report(const char* scenario, uint32_t sps, const char* engine, const Score& s, size_t samples, uint32_t seconds){
+	const size_t valid = s.updates - s.zeros;
+	printf("%-9s %5u %-10s %7zu %6.1f %7.2f %7.1f %9.2f %9.0f\n",
+			scenario, sps, engine, s.updates,
+			s.updates ? 100.0 * s.zeros / s.updates : 0.0,
+			valid ? s.abs_error / valid : 0.0,
+			valid ? 100.0 * s.within / valid : 0.0,
+			samples / s.seconds / 1e6,
+			seconds / s.seconds);
+}
+
+template<size_t SPS>
+void run(const Options& opt, const char* scenario){
+	if (opt.sps != 0 && opt.sps != SPS) return;
+
+	PpgSynthConfig cfg{};
+	PpgSynth::preset(scenario, cfg);
+	cfg.sample_rate = SPS;
+	cfg.seed = opt.seed;
+
+	static Signal signal{};
+	generate(cfg, opt.seconds, signal);
+
+	const size_t truth_span = MAX30102_MEASUREMENT_SECONDS * SPS;
+	const size_t samples = signal.samples.size();
+	using fixed = algo::utils::fixed_math;
+	static const constexpr size_t SECONDS = MAX30102_MEASUREMENT_SECONDS;
+	report(scenario, SPS, "windowed", run_engine<WindowedHr<SPS>>(signal, truth_span), samples, opt.seconds);
+	report(scenario, SPS, "windowed-q", run_engine<WindowedHr<SPS, SECONDS, fixed>>(signal, truth_span), samples, opt.seconds);
+	report(scenario, SPS, "sliding", run_engine<SlidingHr<SPS>>(signal, truth_span), samples, opt.seconds);
+	report(scenario, SPS, "sliding-q", run_engine<SlidingHr<SPS, SECONDS, fixed>>(signal, truth_span), samples, opt.seconds);
+	report(scenario, SPS, "stream", run_engine<StreamingHr<SPS>>(signal, truth_span), samples, opt.seconds);
+	report(scenario, SPS, "stream-q", run_engine<StreamingHr<SPS, SECONDS, fixed>>(signal, truth_span), samples, opt.seconds);
+	report(scenario, SPS, "bp-window", run_engine<BandpassedHr<WindowedHr, SPS>>(signal, truth_span), samples, opt.seconds);
+	report(scenario, SPS, "bp-slide", run_engine<BandpassedHr<SlidingHr, SPS>>(signal, truth_span), samples, opt.seconds);
+	report(scenario, SPS, "bp-slide-q", run_engine<BandpassedHr<SlidingHr, SPS, SECONDS, fixed>>(signal, truth_span), samples, opt.seconds);
+	report(scenario, SPS, "bp-stream", run_engine<BandpassedHr<StreamingHr, SPS>>(signal, truth_span), samples, opt.seconds);
+}
+
+}
+
+int main(int argc, char** argv){
+	Options opt{};
+	if (!parse_options(argc, argv, opt)){
+		fprintf(stderr, "usage: %s [--seconds N] [--seed N] [--sps N] [--scenario rest|exercise|motion]\n", argv[0]);
+		return 2;
+	}
+	if (opt.scenario != nullptr){
+		PpgSynthConfig cfg{};
+		if (!PpgSynth::preset(opt.scenario, cfg)){
+			fprintf(stderr, "unknown scenario %s\n", opt.scenario);
+			return 2;
+		}
+	}
+
+	printf("%-9s %5s %-10s %7s %6s %7s %7s %9s %9s\n",
+			"scenario", "sps", "engine", "updates", "zero%", "MAE", "<=5bpm%", "Msample/s", "x realtime");
+	for (const char* scenario : SCENARIOS){
+		if (opt.scenario != nullptr && strcmp(opt.scenario, scenario)) continue;
+		// MAX30102 SPO2_SR settings
+		run<50>(opt, scenario);
+		run<100>(opt, scenario);
+		run<200>(opt, scenario);
+		run<400>(opt, scenario);
+		run<800>(opt, scenario);
+		run<1000>(opt, scenario);
+		run<1600>(opt, scenario);
+		run<3200>(opt, scenario);
+	}
+	return 0;
+}
@@ -0,0 +1,399 @@
+/*
+ * hr_bench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Host benchmark of HeartRate pipeline and algo::utils stages.
+ *  Reports ns per call and ns per sample for several buffer lengths.
+ *  OxWindow rows process a wrapped SpscRing in place, the copy row is what
+ *  filling an OxStream from the ring cost before that. SlidingHeartRate hop
+ *  is one HR update on a full window, against HeartRate::process redoing it.
+ *  fixed_math rows are the integer only stages, checked against the float
+ *  ones within the bounds documented in algo_utils.hpp before benchmarking.
+ *  PpgBandpass rows filter IR and RED of the whole window, the float and
+ *  fixed_math cascades are checked against each other first.
+ *  smoothed_gradient rows are the fused pass HeartRate::process runs, the
+ *  multi-pass rows the convolution + gradient + standard_deviation it
+ *  replaced, both produce the same derivative (checked first).
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+#include "HeartRate.hpp"
+#include "HeartRateSliding.hpp"
+#include "biquad.hpp"
+#include "algo_utils.hpp"
+#include "etl/standard_deviation.h"
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+static const constexpr size_t REPEATS = 5;
+static const constexpr size_t ITERATIONS = 200;
+static const constexpr int32_t SAMPLE_PERIOD_MS = 1000 / MAX30102_SAMPLES_PER_SECOND;
+using Filter = algo::design::HrFilter<MAX30102_SAMPLES_PER_SECOND>;
+static const constexpr size_t SMOOTHING_SIZE = Filter::SMOOTHING_SIZE;
+static const constexpr uint32_t MIN_PEAK_SAMPLES = Filter::MIN_PEAK_SAMPLES;
+
+template<typename T>
+void do_not_optimize(T const& value){
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// PPG-like signal - DC level, 75 bpm pulse, respiration wander and LCG noise
+template<size_t SIZE>
+void make_signal(BasicOxStream<SIZE>& stream){
+	uint32_t lcg{12345};
+	stream.clear();
+	for (size_t i{0}; i < SIZE; i++){
+		const float t = i * SAMPLE_PERIOD_MS / 1000.0f;
+		lcg = lcg * 1664525u + 1013904223u;
+		const float noise = static_cast<float>(lcg >> 24) - 128.0f;
+		const float pulse = 600.0f * sinf(2.0f * M_PI * 1.25f * t) + 200.0f * sinf(4.0f * M_PI * 1.25f * t);
+		const float resp = 300.0f * sinf(2.0f * M_PI * 0.25f * t);
+		const auto ir = static_cast<int32_t>(60000.0f + pulse + resp + noise);
+		stream.append({static_cast<int32_t>(i) * SAMPLE_PERIOD_MS, ir, ir - 2000});
+	}
+}
+
+// wrapped ring holding the same samples as stream, window starts mid buffer
+template<size_t SIZE>
+void fill_ring(SpscRing<TimestampedOxSample, SIZE>& ring, const BasicOxStream<SIZE>& stream){
+	TimestampedOxSample s{};
+	ring.clear();
+	for (size_t i{0}; i < SIZE / 2; i++) ring.push(s);
+	ring.drop(SIZE / 2);
+	for (size_t i{0}; i < SIZE; i++) ring.push({stream.get_time()[i], stream.get_ir()[i], stream.get_red()[i]});
+}
+
+// best of REPEATS, setup() restores input outside of measured region
+template<typename Setup, typename Work>
+double measure_ns(Setup setup, Work work){
+	double best{0};
+	for (size_t r{0}; r < REPEATS; r++){
+		std::chrono::nanoseconds total{0};
+		for (size_t i{0}; i < ITERATIONS; i++){
+			setup();
+			const auto start = bench_clock::now();
+			work();
+			total += bench_clock::now() - start;
+		}
+		const double ns = static_cast<double>(total.count()) / ITERATIONS;
+		if (r == 0 || ns < best) best = ns;
+	}
+	return best;
+}
+
+void report(const char* name, size_t size, double ns){
+	printf("%-34s %6zu %12.1f %10.2f\n", name, size, ns, ns / size);
+}
+
+template<size_t SIZE>
+bool window_matches_stream(void){
+	static BasicOxStream<SIZE> stream;
+	static SpscRing<TimestampedOxSample, SIZE> ring;
+	make_signal(stream);
+	fill_ring(ring, stream);
+	OxWindow window{ring.peek()};
+
+	HeartRate from_stream{}, from_window{};
+	from_stream.process(stream);
+	from_window.process(window);
+	for (size_t i{0}; i < SIZE; i++){
+		if (stream.get_ir()[i] != window.get_ir()[i]){
+			fprintf(stderr, "OxWindow derivative differs from OxStream at %zu (size %zu)\n", i, SIZE);
+			return false;
+		}
+	}
+	return from_stream.get_hr() == from_window.get_hr();
+}
+
+// fixed_math against float_math on the same smoothed window
+template<size_t SIZE>
+bool fixed_within_bounds(void){
+	using algo::utils::float_math;
+	using algo::utils::fixed_math;
+	static BasicOxStream<SIZE> stream;
+	make_signal(stream);
+	algo::utils::convolution(algo::utils::box_window<int32_t, SMOOTHING_SIZE>{}, stream.get_ir());
+	auto float_grad = stream.get_ir();
+	auto fixed_grad = stream.get_ir();
+	algo::utils::gradient<float_math>(float_grad, stream.get_time());
+	algo::utils::gradient<fixed_math>(fixed_grad, stream.get_time());
+	for (size_t i{0}; i < SIZE; i++){
+		if (abs(float_grad[i] - fixed_grad[i]) > 1){
+			fprintf(stderr, "fixed gradient off by %d at %zu (size %zu)\n", fixed_grad[i] - float_grad[i], i, SIZE);
+			return false;
+		}
+	}
+
+	const int32_t float_sd = algo::utils::standard_deviation(float_math{}, float_grad);
+	const int32_t fixed_sd = algo::utils::standard_deviation(fixed_math{}, float_grad);
+	if (abs(float_sd - fixed_sd) > 1){
+		fprintf(stderr, "fixed std dev %d, float %d (size %zu)\n", fixed_sd, float_sd, SIZE);
+		return false;
+	}
+
+	const auto float_hr = algo::utils::hr_calculator(float_math{}, float_grad, stream.get_time(), float_sd, MIN_PEAK_SAMPLES);
+	const auto fixed_hr = algo::utils::hr_calculator(fixed_math{}, float_grad, stream.get_time(), float_sd, MIN_PEAK_SAMPLES);
+	if (float_hr > fixed_hr + 1 || fixed_hr > float_hr + 1){
+		fprintf(stderr, "fixed HR %u, float %u (size %zu)\n", fixed_hr, float_hr, SIZE);
+		return false;
+	}
+	return true;
+}
+
+// fused pass against the stages run one after another, same derivative, std-dev within the Math bound
+template<size_t SIZE, typename Math, size_t LAG>
+bool fused_matches_multipass(void){
+	static BasicOxStream<SIZE> multi, fused;
+	make_signal(multi);
+	make_signal(fused);
+
+	algo::utils::convolution(algo::utils::box_window<int32_t, SMOOTHING_SIZE>{}, multi.get_ir());
+	algo::utils::gradient<Math>(multi.get_ir(), multi.get_time(), LAG);
+	const int32_t multi_sd = algo::utils::standard_deviation(Math{}, multi.get_ir());
+	const int32_t fused_sd = algo::utils::smoothed_gradient<Math, LAG>(
+			algo::utils::box_window<int32_t, SMOOTHING_SIZE>{}, fused.get_ir(), fused.get_time());
+
+	for (size_t i{0}; i < SIZE; i++){
+		if (multi.get_ir()[i] != fused.get_ir()[i]){
+			fprintf(stderr, "smoothed_gradient differs at %zu (size %zu, lag %zu)\n", i, SIZE, LAG);
+			return false;
+		}
+	}
+	if (abs(multi_sd - fused_sd) > 1){
+		fprintf(stderr, "smoothed_gradient std dev %d, multi-pass %d (size %zu)\n", fused_sd, multi_sd, SIZE);
+		return false;
+	}
+	return true;
+}
+
+template<size_t SIZE>
+bool fused_matches(void){
+	using algo::utils::float_math;
+	using algo::utils::fixed_math;
+	return fused_matches_multipass<SIZE, float_math, Filter::GRADIENT_LAG>() &&
+			fused_matches_multipass<SIZE, fixed_math, Filter::GRADIENT_LAG>() &&
+			fused_matches_multipass<SIZE, float_math, 4>() && fused_matches_multipass<SIZE, fixed_math, 4>();
+}
+
+// Q28 cascade against float on the same window, batch against per sample
+template<size_t SIZE>
+bool bandpass_fixed_within_bounds(void){
+	static BasicOxStream<SIZE> float_stream, fixed_stream, input;
+	make_signal(input);
+	float_stream = input;
+	fixed_stream = input;
+	algo::filter::PpgBandpass<MAX30102_SAMPLES_PER_SECOND, algo::utils::float_math>{}.process(float_stream);
+	algo::filter::PpgBandpass<MAX30102_SAMPLES_PER_SECOND, algo::utils::fixed_math> per_sample{};
+	algo::filter::PpgBandpass<MAX30102_SAMPLES_PER_SECOND, algo::utils::fixed_math>{}.process(fixed_stream);
+
+	for (size_t i{0}; i < SIZE; i++){
+		const auto single = per_sample.process({input.get_time()[i], input.get_ir()[i], input.get_red()[i]});
+		if (single.ir != fixed_stream.get_ir()[i] || single.red != fixed_stream.get_red()[i]){
+			fprintf(stderr, "batch band-pass differs from per sample at %zu (size %zu)\n", i, SIZE);
+			return false;
+		}
+		if (abs(float_stream.get_ir()[i] - fixed_stream.get_ir()[i]) > 2 || abs(float_stream.get_red()[i] - fixed_stream.get_red()[i]) > 2){
+			fprintf(stderr, "fixed band-pass off by %d at %zu (size %zu)\n", fixed_stream.get_ir()[i] - float_stream.get_ir()[i], i, SIZE);
+			return false;
+		}
+	}
+	return true;
+}
+
+template<size_t SIZE>
+void bench_size(void){
+	using array = typename BasicOxStream<SIZE>::array;
+	static BasicOxStream<SIZE> input, work;
+	static array gradient_input;
+	make_signal(input);
+
+	etl::array<int32_t, SMOOTHING_SIZE> ones;
+	ones.fill(1);
+	algo::utils::box_window<int32_t, SMOOTHING_SIZE> box{};
+
+	HeartRate hr_algo{};
+	report("HeartRate::process", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{ hr_algo.process(work); do_not_optimize(hr_algo.get_hr()); }));
+
+	FixedHeartRate fixed_algo{};
+	report("FixedHeartRate::process", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{ fixed_algo.process(work); do_not_optimize(fixed_algo.get_hr()); }));
+
+	static SpscRing<TimestampedOxSample, SIZE> ring;
+	fill_ring(ring, input);
+	OxWindow window{ring.peek()};
+	auto window_ir = window.get_ir();
+	report("HeartRate::process (OxWindow)", SIZE, measure_ns(
+			[&]{ for (size_t i{0}; i < SIZE; i++) window_ir[i] = input.get_ir()[i]; },
+			[&]{ hr_algo.process(window); do_not_optimize(hr_algo.get_hr()); }));
+
+	report("ring -> OxStream clear + copy", SIZE, measure_ns(
+			[]{},
+			[&]{
+				work.clear();
+				for (size_t i{0}; i < SIZE; i++) work.append({window.get_time()[i], window_ir[i], window.get_red()[i]});
+				do_not_optimize(work.get_ir()[SIZE - 1]);
+			}));
+
+	static SlidingHeartRate<SIZE, MAX30102_SAMPLES_PER_SECOND> sliding{};
+	size_t next{0};
+	auto push_next = [&]{
+		const size_t i = next % SIZE;
+		sliding.push({static_cast<int32_t>(next) * SAMPLE_PERIOD_MS, input.get_ir()[i], input.get_red()[i]});
+		next++;
+	};
+	sliding.reset();
+	while (next < SIZE + SMOOTHING_SIZE) push_next();
+	report("SlidingHeartRate hop", SIZE, measure_ns(
+			[]{},
+			[&]{
+				for (size_t i{0}; i < MAX30102_SAMPLES_PER_SECOND; i++) push_next();
+				do_not_optimize(sliding.get_hr());
+			}));
+
+	report("convolution (generic kernel)", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{ algo::utils::convolution(ones, work.get_ir()); do_not_optimize(work.get_ir()[0]); }));
+
+	report("convolution (box_window)", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{ algo::utils::convolution(box, work.get_ir()); do_not_optimize(work.get_ir()[0]); }));
+
+	report("multi-pass smooth + gradient + std", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{
+				algo::utils::convolution(box, work.get_ir());
+				algo::utils::gradient(work.get_ir(), work.get_time(), Filter::GRADIENT_LAG);
+				do_not_optimize(algo::utils::standard_deviation(algo::utils::float_math{}, work.get_ir()));
+			}));
+
+	report("smoothed_gradient", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{
+				do_not_optimize(algo::utils::smoothed_gradient<algo::utils::float_math, Filter::GRADIENT_LAG>(
+						box, work.get_ir(), work.get_time()));
+			}));
+
+	report("multi-pass (fixed_math)", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{
+				algo::utils::convolution(box, work.get_ir());
+				algo::utils::gradient<algo::utils::fixed_math>(work.get_ir(), work.get_time(), Filter::GRADIENT_LAG);
+				do_not_optimize(algo::utils::standard_deviation(algo::utils::fixed_math{}, work.get_ir()));
+			}));
+
+	report("smoothed_gradient (fixed_math)", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{
+				do_not_optimize(algo::utils::smoothed_gradient<algo::utils::fixed_math, Filter::GRADIENT_LAG>(
+						box, work.get_ir(), work.get_time()));
+			}));
+
+	auto window_time = window.get_time();
+	report("multi-pass (OxWindow)", SIZE, measure_ns(
+			[&]{ for (size_t i{0}; i < SIZE; i++) window_ir[i] = input.get_ir()[i]; },
+			[&]{
+				algo::utils::convolution(box, window_ir);
+				algo::utils::gradient(window_ir, window_time, Filter::GRADIENT_LAG);
+				do_not_optimize(algo::utils::standard_deviation(algo::utils::float_math{}, window_ir));
+			}));
+
+	report("smoothed_gradient (OxWindow)", SIZE, measure_ns(
+			[&]{ for (size_t i{0}; i < SIZE; i++) window_ir[i] = input.get_ir()[i]; },
+			[&]{
+				do_not_optimize(algo::utils::smoothed_gradient<algo::utils::float_math, Filter::GRADIENT_LAG>(
+						box, window_ir, window_time));
+			}));
+
+	algo::filter::PpgBandpass<MAX30102_SAMPLES_PER_SECOND, algo::utils::float_math> bandpass{};
+	report("PpgBandpass IR + RED", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{ bandpass.process(work); do_not_optimize(work.get_ir()[0]); }));
+
+	algo::filter::PpgBandpass<MAX30102_SAMPLES_PER_SECOND, algo::utils::fixed_math> fixed_bandpass{};
+	report("PpgBandpass IR + RED (fixed_math)", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{ fixed_bandpass.process(work); do_not_optimize(work.get_ir()[0]); }));
+
+	work = input;
+	algo::utils::convolution(box, work.get_ir());
+	gradient_input = work.get_ir();
+
+	report("gradient", SIZE, measure_ns(
+			[&]{ work.get_ir() = gradient_input; },
+			[&]{ algo::utils::gradient(work.get_ir(), work.get_time()); do_not_optimize(work.get_ir()[0]); }));
+
+	report("gradient (fixed_math)", SIZE, measure_ns(
+			[&]{ work.get_ir() = gradient_input; },
+			[&]{
+				algo::utils::gradient<algo::utils::fixed_math>(work.get_ir(), work.get_time());
+				do_not_optimize(work.get_ir()[0]);
+			}));
+
+	algo::utils::gradient(work.get_ir(), work.get_time());
+	const array derivative = work.get_ir();
+
+	int32_t std_dev{0};
+	report("etl::standard_deviation", SIZE, measure_ns(
+			[]{},
+			[&]{
+				etl::standard_deviation<etl::standard_deviation_type::Population, int32_t> sd(derivative.begin(), derivative.end());
+				std_dev = static_cast<int32_t>(sd.get_standard_deviation());
+				do_not_optimize(std_dev);
+			}));
+
+	report("standard_deviation (fixed_math)", SIZE, measure_ns(
+			[]{},
+			[&]{ do_not_optimize(algo::utils::standard_deviation(algo::utils::fixed_math{}, derivative)); }));
+
+	report("welfords_algorithm", SIZE, measure_ns(
+			[]{},
+			[&]{ do_not_optimize(algo::utils::welfords_algorithm(derivative)); }));
+
+	report("hr_calculator", SIZE, measure_ns(
+			[]{},
+			[&]{ do_not_optimize(algo::utils::hr_calculator(derivative, input.get_time(), std_dev, MIN_PEAK_SAMPLES)); }));
+
+	report("hr_calculator (fixed_math)", SIZE, measure_ns(
+			[]{},
+			[&]{ do_not_optimize(algo::utils::hr_calculator(algo::utils::fixed_math{}, derivative, input.get_time(), std_dev, MIN_PEAK_SAMPLES)); }));
+
+	report("mean", SIZE, measure_ns(
+			[]{},
+			[&]{ do_not_optimize(algo::utils::mean(input.get_ir())); }));
+
+	report("diff", SIZE, measure_ns(
+			[&]{ work = input; },
+			[&]{ algo::utils::diff(work.get_ir()); do_not_optimize(work.get_ir()[0]); }));
+}
+
+}
+
+int main(void){
+	if (!window_matches_stream<200>() || !window_matches_stream<600>() || !window_matches_stream<1200>())
+		return 1;
+	if (!fixed_within_bounds<200>() || !fixed_within_bounds<600>() || !fixed_within_bounds<1200>())
+		return 1;
+	if (!fused_matches<200>() || !fused_matches<600>() || !fused_matches<1200>())
+		return 1;
+	if (!bandpass_fixed_within_bounds<200>() || !bandpass_fixed_within_bounds<600>() || !bandpass_fixed_within_bounds<1200>())
+		return 1;
+
+	printf("%-34s %6s %12s %10s\n", "stage", "N", "ns/call", "ns/sample");
+	bench_size<200>();
+	bench_size<400>();
+	bench_size<600>();
+	bench_size<1200>();
+	return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * hr_pipeline.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Host copies of the firmware HR pipelines, sized by template parameters so
+ *  one binary can run them at several sample rates. Shared by host tools.
+ */
+
+#ifndef HOST_COMMON_HR_PIPELINE_HPP_
+#define HOST_COMMON_HR_PIPELINE_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ox_data_structure.hpp"
+#include "HeartRate.hpp"
+#include "HeartRateStream.hpp"
+#include "HeartRateSliding.hpp"
+#include "biquad.hpp"
+
+/*
+ * Reference for SlidingHr: batch HeartRate recomputed over the whole window
+ * every hop - SpscRing -> OxStream copy -> HeartRate, the ring keeps the
+ * overlap so the window cannot be processed in place. Same window and hop as
+ * Max30102_Task. Finger detection is skipped.
+ */
+template<size_t SPS, size_t SECONDS = MAX30102_MEASUREMENT_SECONDS, typename Math = algo::utils::float_math,
+		bool BANDPASSED = false>
+class WindowedHr {
+public:
+	static const constexpr size_t BUFFER_LENGTH = (SECONDS + 1) * SPS;
+
+	// returns true when sample closed a hop on a full window and HR was updated
+	bool push(const TimestampedOxSample& sample){
+		_ring.push(sample);
+		if (!_ring.full()) return false;
+
+		const OxWindow window{_ring.peek()};
+		_stream.clear();
+		for (size_t i{0}; i < window.size(); i++){
+			_stream.append({window.get_time()[i], window.get_ir()[i], window.get_red()[i]});
+		}
+		_algo.process(_stream);
+		_ring.drop(SPS);
+		return true;
+	}
+
+	uint32_t get_hr(void) { return _algo.get_hr(); }
+	uint32_t overruns(void) const { return _ring.overruns(); }
+
+private:
+	SpscRing<TimestampedOxSample, BUFFER_LENGTH> _ring{};
+	BasicOxStream<BUFFER_LENGTH> _stream{};
+	BasicHeartRate<Math, SPS, BANDPASSED> _algo{};
+};
+
+// Max30102_Task default engine, same window and hop as WindowedHr with filtering reused across hops
+template<size_t SPS, size_t SECONDS = MAX30102_MEASUREMENT_SECONDS, typename Math = algo::utils::float_math,
+		bool BANDPASSED = false>
+class SlidingHr {
+public:
+	bool push(const TimestampedOxSample& sample){ return _algo.push(sample); }
+	uint32_t get_hr(void) { return _algo.get_hr(); }
+	uint32_t overruns(void) const { return 0; }
+
+private:
+	SlidingHeartRate<(SECONDS + 1) * SPS, SPS, SPS, Math, BANDPASSED> _algo{};
+};
+
+// StreamingHeartRate with gradient statistics over the same span as the window
+template<size_t SPS, size_t SECONDS = MAX30102_MEASUREMENT_SECONDS, typename Math = algo::utils::float_math,
+		bool BANDPASSED = false>
+class StreamingHr {
+public:
+	bool push(const TimestampedOxSample& sample){ return _algo.push(sample); }
+	uint32_t get_hr(void) { return _algo.get_hr(); }
+	uint32_t overruns(void) const { return 0; }
+
+private:
+	StreamingHeartRate<SPS, (SECONDS + 1) * SPS, 8, Math, BANDPASSED> _algo{};
+};
+
+// one of the above behind the PpgBandpass front end without its box smoothing, Max30102_CollectSample with MAX30102_USE_BANDPASS
+template<template<size_t, size_t, typename, bool> class Pipeline, size_t SPS, size_t SECONDS = MAX30102_MEASUREMENT_SECONDS,
+		typename Math = algo::utils::float_math>
+class BandpassedHr {
+public:
+	bool push(const TimestampedOxSample& sample){ return _pipeline.push(_bandpass.process(sample)); }
+	uint32_t get_hr(void) { return _pipeline.get_hr(); }
+	uint32_t overruns(void) const { return _pipeline.overruns(); }
+
+private:
+	algo::filter::PpgBandpass<SPS, Math> _bandpass{};
+	Pipeline<SPS, SECONDS, Math, true> _pipeline{};
+};
+
+#endif /* HOST_COMMON_HR_PIPELINE_HPP_ */
@@ -0,0 +1,69 @@
+/*
+ * ppg_csv.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Loader for recorded PPG csv files in scripts/ - shared by host tools.
+ */
+
+#ifndef HOST_COMMON_PPG_CSV_HPP_
+#define HOST_COMMON_PPG_CSV_HPP_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "ox_data_structure.hpp"
+
+struct PpgRecording {
+	std::vector<TimestampedOxSample> samples;
+	int32_t duration_ms{0};	// one sample period past the last sample
+};
+
+/*
+ * Header line decides the layout: "time,IR,RED" (time in seconds) or "IR,RED".
+ * Files without time column get timestamps from sps. Timestamps start at 0 ms.
+ */
+inline bool load_ppg_csv(const char* path, uint32_t sps, PpgRecording& rec){
+	FILE* f = fopen(path, "r");
+	if (f == nullptr){
+		fprintf(stderr, "cannot open %s\n", path);
+		return false;
+	}
+
+	char line[128];
+	if (fgets(line, sizeof(line), f) == nullptr){
+		fclose(f);
+		return false;
+	}
+	const bool has_time = (strncmp(line, "time", 4) == 0);
+
+	rec.samples.clear();
+	int32_t first_ts{-1};
+	while (fgets(line, sizeof(line), f) != nullptr){
+		double t{0}, ir{0}, red{0};
+		int32_t ts{0};
+
+		if (has_time){
+			if (sscanf(line, "%lf,%lf,%lf", &t, &ir, &red) != 3) continue;
+			ts = static_cast<int32_t>(t * 1000.0);
+			if (first_ts < 0) first_ts = ts;
+			ts -= first_ts;
+		} else {
+			if (sscanf(line, "%lf,%lf", &ir, &red) != 2) continue;
+			ts = static_cast<int32_t>((rec.samples.size() * 1000) / sps);
+		}
+		rec.samples.push_back({ts, static_cast<int32_t>(ir), static_cast<int32_t>(red)});
+	}
+	fclose(f);
+
+	if (rec.samples.size() < 2) return false;
+	// loops must not repeat a timestamp
+	const auto& last = rec.samples.back();
+	rec.duration_ms = last.ts + (last.ts / static_cast<int32_t>(rec.samples.size() - 1));
+	return true;
+}
+
+#endif /* HOST_COMMON_PPG_CSV_HPP_ */
@@ -0,0 +1,249 @@
+/*
+ * ppg_synth.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Synthetic PPG generator for host benchmarks. Emits TimestampedOxSample
+ *  streams the way MAX30102 delivers them (ADC counts, ms timestamps) together
+ *  with the true heart rate, so HeartRate accuracy can be scored.
+ *
+ *  Signal model, IR and RED share it with different amplitudes:
+ *    - beats placed by interval, not by phase, so the rate can follow
+ *      a trajectory and every interval gets HRV jitter and respiratory
+ *      sinus arrhythmia,
+ *    - pulse shape is a systolic and a smaller dicrotic gaussian, blood
+ *      volume rise lowers reflected light so the pulse is subtracted from DC,
+ *    - respiration modulates pulse amplitude and adds baseline wander,
+ *    - DC drifts linearly plus a slow random walk,
+ *    - motion bursts arrive as a Poisson process, each is a low frequency
+ *      oscillation with a step, under a raised cosine envelope,
+ *    - white gaussian noise.
+ *
+ *  Random numbers come from a private xorshift generator and Box-Muller, not
+ *  from <random> distributions, so a seed gives the same stream everywhere.
+ */
+
+#ifndef HOST_COMMON_PPG_SYNTH_HPP_
+#define HOST_COMMON_PPG_SYNTH_HPP_
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#include "ox_data_structure.hpp"
+
+struct PpgSynthConfig {
+	struct HrPoint {
+		double t_s;
+		double bpm;
+	};
+
+	uint32_t sample_rate{100};
+	uint64_t seed{1};
+
+	// heart rate trajectory, linear between points, held after the last one
+	std::vector<HrPoint> hr{{0.0, 72.0}};
+	double hrv_ms{25.0};		// beat to beat interval jitter, standard deviation
+	double rsa_ms{20.0};		// interval modulation by respiration, amplitude
+
+	double resp_hz{0.25};
+	double resp_am{0.10};		// pulse amplitude modulation depth
+	double resp_wander{150.0};	// baseline wander amplitude, counts
+
+	double dc_ir{65000.0};
+	double dc_red{64000.0};
+	double ac_ir{600.0};		// pulse peak to peak, counts
+	double ac_red{400.0};
+	double drift_per_min{300.0};	// linear DC drift, counts per minute
+	double drift_walk{10.0};	// DC random walk, counts per sqrt(s)
+
+	double motion_per_min{0.0};	// mean motion bursts per minute, 0 - none
+	double motion_s{2.0};		// burst length
+	double motion_amp{3000.0};	// burst amplitude, counts
+
+	double noise{15.0};		// white noise standard deviation, counts
+};
+
+struct PpgSynthSample {
+	TimestampedOxSample sample;
+	float true_bpm;		// 60 / length of the beat the sample falls into
+	bool motion;		// sample is inside a motion burst
+};
+
+class PpgSynth {
+public:
+	explicit PpgSynth(const PpgSynthConfig& cfg) : _cfg{cfg} { reset(); };
+
+	void reset(void){
+		_rng = _cfg.seed ? _cfg.seed : 0x9E3779B97F4A7C15ull;
+		_spare_valid = false;
+		_index = 0;
+		_beat_start = 0.0;
+		_beat_len = beat_interval(0.0);
+		_walk = 0.0;
+		_motion_start = -1.0;
+		_next_motion = next_motion_gap(0.0);
+	}
+
+	PpgSynthSample next(void){
+		const double t = static_cast<double>(_index++) / _cfg.sample_rate;
+		const double dt = 1.0 / _cfg.sample_rate;
+
+		while (t >= _beat_start + _beat_len){
+			_beat_start += _beat_len;
+			_beat_len = beat_interval(_beat_start);
+		}
+
+		const double two_pi = 2.0 * M_PI;
+		const double resp = sin(two_pi * _cfg.resp_hz * t);
+		const double pulse = pulse_shape((t - _beat_start) / _beat_len) * (1.0 + _cfg.resp_am * resp);
+
+		_walk += _cfg.drift_walk * sqrt(dt) * gaussian();
+		const double baseline = _cfg.resp_wander * resp + _cfg.drift_per_min * t / 60.0 + _walk;
+
+		double artifact{0.0};
+		const bool motion = motion_at(t, artifact);
+
+		const double ir = _cfg.dc_ir + baseline + artifact - _cfg.ac_ir * pulse + _cfg.noise * gaussian();
+		const double red = _cfg.dc_red + baseline * (_cfg.dc_red / _cfg.dc_ir) + artifact * 0.8 - _cfg.ac_red * pulse + _cfg.noise * gaussian();
+
+		PpgSynthSample out;
+		out.sample.ts = static_cast<int32_t>(t * 1000.0);
+		out.sample.ir = clamp_adc(ir);
+		out.sample.red = clamp_adc(red);
+		out.true_bpm = static_cast<float>(60.0 / _beat_len);
+		out.motion = motion;
+		return out;
+	}
+
+	const PpgSynthConfig& config(void) const { return _cfg; }
+
+	// named scenarios used by hr_accuracy and ppg_gen, false for unknown name
+	static bool preset(const char* name, PpgSynthConfig& cfg){
+		if (!strcmp(name, "rest")){
+			cfg.hr = {{0.0, 64.0}, {120.0, 70.0}, {240.0, 62.0}};
+			return true;
+		}
+		if (!strcmp(name, "exercise")){
+			// warm up, ramp to 170 bpm, hold, recovery
+			cfg.hr = {{0.0, 80.0}, {60.0, 100.0}, {180.0, 170.0}, {240.0, 170.0}, {300.0, 110.0}};
+			cfg.hrv_ms = 8.0;
+			cfg.rsa_ms = 5.0;
+			cfg.resp_hz = 0.5;
+			cfg.noise = 25.0;
+			return true;
+		}
+		if (!strcmp(name, "motion")){
+			cfg.hr = {{0.0, 75.0}, {150.0, 95.0}, {300.0, 80.0}};
+			cfg.motion_per_min = 4.0;
+			cfg.noise = 40.0;
+			return true;
+		}
+		return false;
+	}
+
+private:
+	static const constexpr int32_t ADC_MAX = (1 << 18) - 1;
+
+	static int32_t clamp_adc(double v){
+		if (v < 0.0) return 0;
+		if (v > ADC_MAX) return ADC_MAX;
+		return static_cast<int32_t>(v);
+	}
+
+	// peak at 1.0, systolic peak early in the beat, dicrotic wave after the notch
+	static double pulse_shape(double phase){
+		const double s = (phase - 0.20) / 0.08;
+		const double d = (phase - 0.55) / 0.10;
+		return exp(-0.5 * s * s) + 0.35 * exp(-0.5 * d * d);
+	}
+
+	double hr_at(double t) const {
+		const auto& hr = _cfg.hr;
+		if (hr.empty()) return 60.0;
+		if (t <= hr.front().t_s) return hr.front().bpm;
+		for (size_t i{1}; i < hr.size(); i++){
+			if (t < hr[i].t_s){
+				const double k = (t - hr[i-1].t_s) / (hr[i].t_s - hr[i-1].t_s);
+				return hr[i-1].bpm + k * (hr[i].bpm - hr[i-1].bpm);
+			}
+		}
+		return hr.back().bpm;
+	}
+
+	double beat_interval(double t){
+		const double base = 60.0 / hr_at(t);
+		const double rsa = _cfg.rsa_ms * 1e-3 * sin(2.0 * M_PI * _cfg.resp_hz * t);
+		const double jitter = _cfg.hrv_ms * 1e-3 * gaussian();
+		// keep physiological limits whatever the jitter, 30 - 240 bpm
+		const double interval = base + rsa + jitter;
+		return interval < 0.25 ? 0.25 : (interval > 2.0 ? 2.0 : interval);
+	}
+
+	double next_motion_gap(double t){
+		if (_cfg.motion_per_min <= 0.0) return -1.0;
+		return t - log(1.0 - uniform()) * 60.0 / _cfg.motion_per_min;
+	}
+
+	bool motion_at(double t, double& artifact){
+		if (_motion_start < 0.0 && _next_motion >= 0.0 && t >= _next_motion){
+			_motion_start = t;
+			_motion_hz = 0.5 + 2.5 * uniform();
+			_motion_step = (uniform() - 0.5) * _cfg.motion_amp;
+		}
+		if (_motion_start < 0.0) return false;
+
+		const double k = (t - _motion_start) / _cfg.motion_s;
+		if (k >= 1.0){
+			_motion_start = -1.0;
+			_next_motion = next_motion_gap(t);
+			return false;
+		}
+		const double envelope = 0.5 * (1.0 - cos(2.0 * M_PI * k));
+		artifact = envelope * (_cfg.motion_amp * sin(2.0 * M_PI * _motion_hz * (t - _motion_start)) + _motion_step);
+		return true;
+	}
+
+	// xorshift64*
+	uint64_t next_u64(void){
+		_rng ^= _rng >> 12;
+		_rng ^= _rng << 25;
+		_rng ^= _rng >> 27;
+		return _rng * 0x2545F4914F6CDD1Dull;
+	}
+
+	// [0, 1)
+	double uniform(void){ return (next_u64() >> 11) * (1.0 / 9007199254740992.0); }
+
+	double gaussian(void){
+		if (_spare_valid){
+			_spare_valid = false;
+			return _spare;
+		}
+		const double u1 = 1.0 - uniform();
+		const double u2 = uniform();
+		const double r = sqrt(-2.0 * log(u1));
+		_spare = r * sin(2.0 * M_PI * u2);
+		_spare_valid = true;
+		return r * cos(2.0 * M_PI * u2);
+	}
+
+	PpgSynthConfig _cfg;
+	uint64_t _rng;
+	double _spare;
+	bool _spare_valid;
+
+	uint64_t _index;
+	double _beat_start;
+	double _beat_len;
+	double _walk;
+
+	double _motion_start;
+	double _next_motion;
+	double _motion_hz{0.0};
+	double _motion_step{0.0};
+};
+
+#endif /* HOST_COMMON_PPG_SYNTH_HPP_ */
@@ -0,0 +1,73 @@
+/*
+ * FreeRTOSConfig.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Host (FreeRTOS POSIX port) counterpart of Core/Inc/FreeRTOSConfig.h.
+ *  Kernel options follow the firmware, Cortex-M interrupt priorities do not apply.
+ *  Task switch trace hooks feed posix_trace.h for scheduling statistics.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include "posix_trace.h"
+
+#define configUSE_PREEMPTION                     1
+#define configSUPPORT_STATIC_ALLOCATION          0
+#define configSUPPORT_DYNAMIC_ALLOCATION         1
+#define configUSE_IDLE_HOOK                      0
+#define configUSE_TICK_HOOK                      0
+#define configUSE_MALLOC_FAILED_HOOK             1
+#define configTICK_RATE_HZ                       ((TickType_t)1000)
+#define configMAX_PRIORITIES                     ( 56 )
+#define configMINIMAL_STACK_SIZE                 ((uint16_t)256)
+/* task stacks are in StackType_t (8 bytes here), heap is sized for that */
+#define configTOTAL_HEAP_SIZE                    ((size_t)(512 * 1024))
+#define configMAX_TASK_NAME_LEN                  ( 16 )
+#define configUSE_TRACE_FACILITY                 1
+#define configUSE_16_BIT_TICKS                   0
+#define configUSE_MUTEXES                        1
+#define configQUEUE_REGISTRY_SIZE                8
+/* pthread stacks, nothing for the kernel to check */
+#define configCHECK_FOR_STACK_OVERFLOW           0
+#define configUSE_RECURSIVE_MUTEXES              1
+#define configUSE_COUNTING_SEMAPHORES            1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION  0
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES                    0
+#define configMAX_CO_ROUTINE_PRIORITIES          ( 2 )
+
+/* Software timer definitions. */
+#define configUSE_TIMERS                         1
+#define configTIMER_TASK_PRIORITY                ( 2 )
+#define configTIMER_QUEUE_LENGTH                 10
+#define configTIMER_TASK_STACK_DEPTH             512
+
+#define INCLUDE_vTaskPrioritySet            1
+#define INCLUDE_uxTaskPriorityGet           1
+#define INCLUDE_vTaskDelete                 1
+#define INCLUDE_vTaskCleanUpResources       0
+#define INCLUDE_vTaskSuspend                1
+#define INCLUDE_vTaskDelayUntil             1
+#define INCLUDE_vTaskDelay                  1
+#define INCLUDE_xTaskGetSchedulerState      1
+#define INCLUDE_xTimerPendFunctionCall      1
+#define INCLUDE_xQueueGetMutexHolder        1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+#define INCLUDE_eTaskGetState               1
+#define INCLUDE_pcTaskGetTaskName           1
+
+#define configASSERT( x ) if ((x) == 0) vAssertCalled(__FILE__, __LINE__)
+
+#define traceTASK_SWITCHED_IN()     PosixTrace_SwitchedIn(pxCurrentTCB)
+#define traceTASK_SWITCHED_OUT()    PosixTrace_SwitchedOut(pxCurrentTCB)
+
+// same 100 kHz resolution as TIM2 on target
+#define configGENERATE_RUN_TIME_STATS            1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()         PosixTrace_RunTimeCounter()
+
+#endif /* FREERTOS_CONFIG_H */
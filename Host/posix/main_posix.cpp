@@ -0,0 +1,274 @@
+/*
+ * main_posix.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Firmware task graph (App_CreateTasks) on the FreeRTOS POSIX port, for
+ *  soak runs on a dev box. HAL I2C and GPIO are host stand-ins on wall
+ *  time, MAX30102 is Max30102Model. Two host-only tasks are added:
+ *
+ *  - exti   - highest priority, samples the INT pin every tick and calls
+ *             HAL_GPIO_EXTI_Callback on falling edges, standing in for EXTI15_10
+ *  - soak   - lowest priority, prints a report to stderr every --report-s
+ *             and a last one when --seconds is up
+ *
+ *  usage: firmware_posix [--csv file.csv [--csv-sps N] | --bpm N]
+ *                        [--seconds N] [--report-s N] [--dma] [--trace file.bin]
+ *                        [--telemetry file.bin | --telemetry-pty]
+ *
+ *  --seconds 0 runs until killed. HR printed by max30102_task goes to stdout,
+ *  redirect it to /dev/null for long runs. --trace writes binary TRACE records,
+ *  decode with: scripts/trace_decoder.py build-host/firmware_posix file.bin --clock-hz 1e9
+ *  --telemetry writes the framed telemetry stream, decode with scripts/telemetry.py.
+ *  --telemetry-pty sends it through UartTransport and the USART1 stand-in to a
+ *  pty instead, the path is printed at start: scripts/telemetry.py --port /dev/pts/N
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+
+#include "main.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_tasks.h"
+
+#include "sim_clock.hpp"
+#include "sim_i2c.hpp"
+#include "sim_gpio.hpp"
+#include "max30102_model.hpp"
+#include "ppg_source.hpp"
+#include "ppg_csv.hpp"
+#include "posix_trace.h"
+#include "posix_usart.h"
+#include "profiler.hpp"
+#include "trace.hpp"
+#include "telemetry.hpp"
+#include "uart_transport.hpp"
+
+I2C_HandleTypeDef hi2c1;
+static DMA_HandleTypeDef hdma_i2c1_rx;
+
+void Error_Handler(void)
+{
+	fprintf(stderr, "Error_Handler\n");
+	abort();
+}
+
+extern "C" void vApplicationMallocFailedHook(void)
+{
+	fprintf(stderr, "FreeRTOS heap exhausted\n");
+	abort();
+}
+
+namespace {
+
+struct Options {
+	const char* csv{nullptr};
+	uint32_t csv_sps{MAX30102_SAMPLES_PER_SECOND};
+	float bpm{72.0f};
+	uint32_t seconds{3600};
+	uint32_t report_s{60};
+	bool dma{false};
+	const char* trace{nullptr};
+	const char* telemetry{nullptr};
+	bool telemetry_pty{false};
+};
+
+Options opt{};
+sim::Max30102Model* sensor{nullptr};
+
+TaskHandle_t exti_task_handle;
+TaskHandle_t soak_task_handle;
+
+// debug LED toggles every vTaskDelay(500), its period shows scheduling jitter
+struct LedTiming {
+	uint64_t last_us{0};
+	uint64_t toggles{0};
+	uint64_t min_period_us{UINT64_MAX};
+	uint64_t max_period_us{0};
+} led_timing;
+
+void led_observer(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state){
+	(void)state;
+	if (port != DB_LED_GPIO_Port || pin != DB_LED_Pin) return;
+
+	const uint64_t now = sim::Clock::now_us();
+	if (led_timing.toggles != 0){
+		const uint64_t period = now - led_timing.last_us;
+		if (period < led_timing.min_period_us) led_timing.min_period_us = period;
+		if (period > led_timing.max_period_us) led_timing.max_period_us = period;
+	}
+	led_timing.last_us = now;
+	led_timing.toggles++;
+}
+
+bool parse_options(int argc, char** argv){
+	for (int i{1}; i < argc; i++){
+		const bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--csv") && has_value) opt.csv = argv[++i];
+		else if (!strcmp(argv[i], "--csv-sps") && has_value) opt.csv_sps = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--bpm") && has_value) opt.bpm = strtof(argv[++i], nullptr);
+		else if (!strcmp(argv[i], "--seconds") && has_value) opt.seconds = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--report-s") && has_value) opt.report_s = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--dma")) opt.dma = true;
+		else if (!strcmp(argv[i], "--trace") && has_value) opt.trace = argv[++i];
+		else if (!strcmp(argv[i], "--telemetry") && has_value) opt.telemetry = argv[++i];
+		else if (!strcmp(argv[i], "--telemetry-pty")) opt.telemetry_pty = true;
+		else return false;
+	}
+	return opt.report_s > 0 && opt.csv_sps > 0 && opt.bpm > 0 && !(opt.telemetry != nullptr && opt.telemetry_pty);
+}
+
+void exti_task_handler(void* params){
+	(void)params;
+	uint64_t seen_edges{0};
+
+	while(1){
+		uint64_t edges{seen_edges};
+		{
+			// acquisition task may be preempted inside a transfer, try again next tick then
+			std::unique_lock<std::mutex> lock(sim::I2cBus::mutex(), std::try_to_lock);
+			if (lock.owns_lock()){
+				sensor->advance_to(sim::Clock::now_us());
+				edges = sensor->interrupt_edges();
+				if (sensor->interrupt_asserted()) SimGPIOA.IDR &= ~MAX_INT_Pin;
+				else SimGPIOA.IDR |= MAX_INT_Pin;
+			}
+		}
+
+		if (edges != seen_edges){
+			seen_edges = edges;
+			HAL_GPIO_EXTI_Callback(MAX_INT_Pin);
+		}
+		vTaskDelay(1);
+	}
+}
+
+void report(void){
+	const double uptime_s = sim::Clock::now_us() / 1e6;
+	sim::Max30102Stats dev;
+	{
+		std::lock_guard<std::mutex> lock(sim::I2cBus::mutex());
+		dev = sensor->stats();
+	}
+	const auto& bus = sim::I2cBus::stats();
+
+	fprintf(stderr, "[%10.1f s] hr %u bpm | sensor %llu produced, %llu read, %llu lost, max fill %u\n",
+			uptime_s, static_cast<unsigned>(get_hr()),
+			static_cast<unsigned long long>(dev.produced), static_cast<unsigned long long>(dev.popped),
+			static_cast<unsigned long long>(dev.lost), dev.max_fill);
+	fprintf(stderr, "  latency: INT edge to status read %.0f us mean, %llu us max; sample to read %.0f us mean, %llu us max\n",
+			dev.irq_served ? static_cast<double>(dev.irq_latency_sum_us) / dev.irq_served : 0.0,
+			static_cast<unsigned long long>(dev.irq_latency_max_us),
+			dev.popped ? static_cast<double>(dev.sample_latency_sum_us) / dev.popped : 0.0,
+			static_cast<unsigned long long>(dev.sample_latency_max_us));
+	fprintf(stderr, "  i2c: %llu transfers, bus busy %.2f%%, %llu NACK | debug LED period %llu..%llu us over %llu toggles\n",
+			static_cast<unsigned long long>(bus.transfers),
+			uptime_s > 0 ? 100.0 * bus.busy_us / (uptime_s * 1e6) : 0.0,
+			static_cast<unsigned long long>(bus.nacks),
+			static_cast<unsigned long long>(led_timing.toggles > 1 ? led_timing.min_period_us : 0),
+			static_cast<unsigned long long>(led_timing.max_period_us),
+			static_cast<unsigned long long>(led_timing.toggles));
+	PosixTrace_Report(stderr, uptime_s);
+	profiler::dump(stderr);
+}
+
+void soak_task_handler(void* params){
+	(void)params;
+	const uint64_t end_ms = opt.seconds * 1000ull;
+	uint64_t next_report_ms = sim::Clock::now_ms() + opt.report_s * 1000ull;
+
+	while(1){
+		// next report or end of run, whichever comes first
+		const uint64_t wake_ms = (end_ms != 0 && end_ms < next_report_ms) ? end_ms : next_report_ms;
+		const uint64_t now_ms = sim::Clock::now_ms();
+		if (wake_ms > now_ms) vTaskDelay(pdMS_TO_TICKS(wake_ms - now_ms) + 1);
+
+		const bool finished = end_ms != 0 && sim::Clock::now_ms() >= end_ms;
+		if (finished || sim::Clock::now_ms() >= next_report_ms){
+			report();
+			next_report_ms += opt.report_s * 1000ull;
+		}
+		if (finished){
+			fflush(stdout);
+			exit(0);
+		}
+	}
+}
+
+}
+
+int main(int argc, char** argv){
+	if (!parse_options(argc, argv)){
+		fprintf(stderr, "usage: %s [--csv file.csv [--csv-sps N] | --bpm N] [--seconds N] [--report-s N] [--dma] [--trace file.bin] [--telemetry file.bin | --telemetry-pty]\n", argv[0]);
+		return 2;
+	}
+
+	static PpgRecording rec{};
+	sim::SyntheticPpgSource::Config synth_cfg{};
+	synth_cfg.bpm = opt.bpm;
+	static sim::SyntheticPpgSource synthetic{synth_cfg};
+	sim::PpgSource* source = &synthetic;
+
+	if (opt.csv != nullptr){
+		if (!load_ppg_csv(opt.csv, opt.csv_sps, rec)){
+			fprintf(stderr, "no samples in %s\n", opt.csv);
+			return 1;
+		}
+		static sim::CsvPpgSource csv_source{rec};
+		source = &csv_source;
+	}
+
+	sim::Clock::use_wall_time(true);
+	static sim::Max30102Model model{*source};
+	sensor = &model;
+	sim::I2cBus::attach(MAX30102_ADDRESS, sensor);
+
+	// what MX_GPIO_Init, MX_DMA_Init and MX_I2C1_Init set up on target
+	MX_GPIO_Init();
+	hi2c1.Instance = I2C1;
+	hi2c1.Init.ClockSpeed = 400000;
+	hi2c1.hdmarx = opt.dma ? &hdma_i2c1_rx : NULL;
+	sim::Gpio::set_observer(led_observer);
+
+	if (opt.trace != nullptr){
+		FILE* trace_file = fopen(opt.trace, "wb");
+		if (trace_file == nullptr){
+			fprintf(stderr, "cannot open %s\n", opt.trace);
+			return 1;
+		}
+		trace::set_output(trace_file);
+	}
+	if (opt.telemetry != nullptr){
+		FILE* telemetry_file = fopen(opt.telemetry, "wb");
+		if (telemetry_file == nullptr){
+			fprintf(stderr, "cannot open %s\n", opt.telemetry);
+			return 1;
+		}
+		static FileTransport file_transport{telemetry_file};
+		telemetry::set_transport(&file_transport);
+	}
+	if (opt.telemetry_pty){
+		const char* pty = PosixUsart_OpenPty();
+		if (pty == nullptr){
+			fprintf(stderr, "cannot open a pty\n");
+			return 1;
+		}
+		fprintf(stderr, "telemetry on %s\n", pty);
+		telemetry::set_transport(&uart_transport);
+	}
+
+	profiler::init();
+	App_CreateTasks();
+	configASSERT(xTaskCreate(exti_task_handler, "exti", configMINIMAL_STACK_SIZE, NULL, configMAX_PRIORITIES - 1, &exti_task_handle) == pdPASS);
+	configASSERT(xTaskCreate(soak_task_handler, "soak", 1024, NULL, 1, &soak_task_handle) == pdPASS);
+
+	vTaskStartScheduler();
+	return 1;
+}
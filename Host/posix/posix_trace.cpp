@@ -0,0 +1,101 @@
+/*
+ * posix_trace.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "posix_trace.h"
+
+namespace {
+
+	static const constexpr size_t MAX_TASKS = 16;
+
+	// hooks run inside the kernel, report reads concurrently from a task
+	struct TaskTrace {
+		std::atomic<void*> tcb{nullptr};
+		std::atomic<uint64_t> wakeups{0};
+		std::atomic<uint64_t> run_ns{0};
+		std::atomic<uint64_t> max_slice_ns{0};
+		uint64_t switched_in_ns{0};
+	};
+
+	TaskTrace traces[MAX_TASKS];
+
+	uint64_t now_ns(void){
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	TaskTrace* find(void* tcb){
+		for (auto& trace : traces){
+			void* current = trace.tcb.load(std::memory_order_relaxed);
+			if (current == tcb) return &trace;
+			if (current == nullptr){
+				trace.tcb.store(tcb, std::memory_order_relaxed);
+				return &trace;
+			}
+		}
+		return nullptr;
+	}
+
+}
+
+extern "C" {
+
+void vAssertCalled(const char *file, unsigned long line)
+{
+	fprintf(stderr, "configASSERT failed: %s:%lu\n", file, line);
+	abort();
+}
+
+unsigned long PosixTrace_RunTimeCounter(void)
+{
+	return static_cast<unsigned long>(now_ns() / 10000);
+}
+
+void PosixTrace_SwitchedIn(void *tcb)
+{
+	TaskTrace* trace = find(tcb);
+	if(trace == nullptr) return;
+	trace->wakeups.fetch_add(1, std::memory_order_relaxed);
+	trace->switched_in_ns = now_ns();
+}
+
+void PosixTrace_SwitchedOut(void *tcb)
+{
+	TaskTrace* trace = find(tcb);
+	if(trace == nullptr || trace->switched_in_ns == 0) return;
+
+	const uint64_t slice = now_ns() - trace->switched_in_ns;
+	trace->run_ns.fetch_add(slice, std::memory_order_relaxed);
+	if(slice > trace->max_slice_ns.load(std::memory_order_relaxed))
+		trace->max_slice_ns.store(slice, std::memory_order_relaxed);
+}
+
+void PosixTrace_Report(FILE *out, double elapsed_s)
+{
+	fprintf(out, "  %-16s %10s %7s %12s %12s\n", "task", "wakeups", "cpu %", "ns/wakeup", "max ns");
+	for(auto& trace : traces)
+	{
+		void* tcb = trace.tcb.load(std::memory_order_relaxed);
+		if(tcb == nullptr) break;
+
+		const uint64_t wakeups = trace.wakeups.load(std::memory_order_relaxed);
+		const uint64_t run_ns = trace.run_ns.load(std::memory_order_relaxed);
+		fprintf(out, "  %-16s %10llu %7.3f %12.0f %12llu\n",
+				pcTaskGetName(static_cast<TaskHandle_t>(tcb)),
+				static_cast<unsigned long long>(wakeups),
+				elapsed_s > 0 ? 100.0 * run_ns / (elapsed_s * 1e9) : 0.0,
+				wakeups ? static_cast<double>(run_ns) / wakeups : 0.0,
+				static_cast<unsigned long long>(trace.max_slice_ns.load(std::memory_order_relaxed)));
+	}
+}
+
+}
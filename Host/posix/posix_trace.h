@@ -0,0 +1,35 @@
+/*
+ * posix_trace.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Per task wake-up count and host CPU time, collected from
+ *  traceTASK_SWITCHED_IN/OUT. Included by kernel C sources through FreeRTOSConfig.h.
+ */
+
+#ifndef HOST_POSIX_POSIX_TRACE_H_
+#define HOST_POSIX_POSIX_TRACE_H_
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void vAssertCalled(const char *file, unsigned long line);
+
+void PosixTrace_SwitchedIn(void *tcb);
+void PosixTrace_SwitchedOut(void *tcb);
+
+// FreeRTOS run time statistics clock, host monotonic time in 10 us units
+unsigned long PosixTrace_RunTimeCounter(void);
+
+// one line per task: wake-ups, CPU share, mean and max time per wake-up
+void PosixTrace_Report(FILE *out, double elapsed_s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_POSIX_POSIX_TRACE_H_ */
@@ -0,0 +1,92 @@
+/*
+ * posix_usart.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+// before termios.h, which defines CR1 and friends used as register names by the HAL stand-ins
+#include "usart.h"
+#include "posix_usart.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+	int master_fd{-1};
+
+	// one transfer at a time, the DMA stream
+	std::mutex mutex;
+	std::condition_variable pending;
+	const uint8_t* tx_data{nullptr};
+	uint16_t tx_len{0};
+	bool busy{false};
+
+	void dma_thread(void){
+		while (true){
+			const uint8_t* data;
+			uint16_t len;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				pending.wait(lock, []{ return tx_data != nullptr; });
+				data = tx_data;
+				len = tx_len;
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			// a full pty buffer is a receiver not keeping up, the bytes are lost like on the wire
+			size_t done{0};
+			while (done < len){
+				const ssize_t n = ::write(master_fd, data + done, len - done);
+				if (n <= 0 && errno == EINTR) continue;
+				if (n <= 0) break;
+				done += static_cast<size_t>(n);
+			}
+			// 8N1, 10 bits per byte
+			std::this_thread::sleep_until(start + std::chrono::microseconds(10ULL * 1000000ULL * len / USART1_BAUD_RATE));
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tx_data = nullptr;
+				busy = false;
+			}
+			USART1_TxCompleteCallback();
+		}
+	}
+
+}
+
+const char *PosixUsart_OpenPty(void)
+{
+	master_fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (master_fd < 0 || grantpt(master_fd) != 0 || unlockpt(master_fd) != 0) return NULL;
+
+	// raw bytes, no newline translation or echo on the frames
+	struct termios tio;
+	if (tcgetattr(master_fd, &tio) == 0){
+		cfmakeraw(&tio);
+		tcsetattr(master_fd, TCSANOW, &tio);
+	}
+
+	std::thread(dma_thread).detach();
+	return ptsname(master_fd);
+}
+
+int USART1_TransmitDMA(const uint8_t *data, uint16_t len)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (busy || master_fd < 0) return 0;
+	busy = true;
+	tx_data = data;
+	tx_len = len;
+	pending.notify_one();
+	return 1;
+}
@@ -0,0 +1,28 @@
+/*
+ * posix_usart.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  USART1 TX DMA stand-in for firmware_posix. Transfers are written to the
+ *  master side of a pseudo terminal by a host thread, which then sleeps for
+ *  the time the bytes take on the wire at USART1_BAUD_RATE and raises the
+ *  completion callback, like the DMA2 stream7 interrupt on target. Open the
+ *  slave side with scripts/telemetry.py --port, nobody reading drops output.
+ */
+
+#ifndef HOST_POSIX_POSIX_USART_H_
+#define HOST_POSIX_POSIX_USART_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// creates the pty and the transfer thread, returns the slave path or NULL
+const char *PosixUsart_OpenPty(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_POSIX_POSIX_USART_H_ */
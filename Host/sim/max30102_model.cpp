@@ -0,0 +1,285 @@
+/*
+ * max30102_model.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include <string.h>
+
+#include "main.h"
+#include "MAX30102/MAX30102.hpp"
+#include "max30102_model.hpp"
+
+namespace sim {
+
+	namespace {
+
+		const uint32_t SAMPLE_RATES[8] = {50, 100, 200, 400, 800, 1000, 1600, 3200};
+
+		// highest rate allowed for LED_PW setting, SpO2 mode (both LEDs) and HR mode (one LED)
+		const uint32_t MAX_RATE_SPO2[4] = {1600, 1000, 1000, 400};
+		const uint32_t MAX_RATE_HR[4] = {3200, 1600, 1600, 1000};
+
+		const uint32_t ADC_RANGE_NA[4] = {2048, 4096, 8192, 16384};
+
+		// reference settings for PpgSource levels
+		const float REFERENCE_PA = MAX30102_IR_LED_CURRENT_HIGH;
+		const float REFERENCE_RANGE_NA = 4096.0f;
+
+		const uint32_t ADC_MAX = 0x3FFFF;
+
+		uint8_t field(uint8_t value, uint8_t bit, uint8_t length){
+			return (value >> (bit - length + 1)) & ((1 << length) - 1);
+		}
+
+	}
+
+	Max30102Model::Max30102Model(PpgSource& source) : _source{source}, _int_asserted_us{0}, _int_edges{0}, _now_us{0} {
+		power_on_reset();
+	}
+
+	void Max30102Model::power_on_reset(void){
+		memset(_regs, 0, sizeof(_regs));
+		memset(_fifo, 0, sizeof(_fifo));
+		_regs[REG_INTR_STATUS_1] = 1 << INT_PWR_RDY_BIT;
+		_regs[REG_REV_ID] = REV_ID;
+		_regs[REG_PART_ID] = PART_ID;
+		_wr_ptr = 0;
+		_rd_ptr = 0;
+		_ovf_counter = 0;
+		_count = 0;
+		_byte_index = 0;
+		_int_line = false;
+		update_int_line();
+		restart_sampling(_now_us);
+	}
+
+	uint8_t Max30102Model::active_leds(void) const {
+		const uint8_t mode = field(_regs[REG_MODE_CONFIG], MODE_MODE_BIT, MODE_MODE_LENGTH);
+		if (_regs[REG_MODE_CONFIG] & (1 << MODE_SHDN_BIT)) return 0;
+		if (mode == MODE_HEART_RATE_MODE) return 1;
+		if (mode == MODE_SPO2_MODE || mode == MODE_MULTI_LED_MODE) return 2;
+		return 0;
+	}
+
+	uint32_t Max30102Model::output_rate_hz(void) const {
+		const uint8_t leds = active_leds();
+		if (leds == 0) return 0;
+
+		const uint8_t spo2 = _regs[REG_SPO2_CONFIG];
+		const uint8_t pw = field(spo2, SPO2_CONF_LED_PW_BIT, SPO2_CONF_LED_PW_LENGTH);
+		uint32_t rate = SAMPLE_RATES[field(spo2, SPO2_CONF_SR_BIT, SPO2_CONF_SR_LENGTH)];
+		const uint32_t max_rate = (leds == 1) ? MAX_RATE_HR[pw] : MAX_RATE_SPO2[pw];
+		if (rate > max_rate) rate = max_rate;
+
+		uint8_t ave = field(_regs[REG_FIFO_CONFIG], FIFO_CONF_SMP_AVE_BIT, FIFO_CONF_SMP_AVE_LENGHT);
+		if (ave > FIFO_SMP_AVE_32) ave = FIFO_SMP_AVE_32;
+		return rate >> ave;
+	}
+
+	void Max30102Model::restart_sampling(uint64_t us){
+		_epoch_us = us;
+		_converted = 0;
+	}
+
+	void Max30102Model::advance_to(uint64_t us){
+		const uint32_t rate = output_rate_hz();
+
+		if (rate != 0){
+			for (;;){
+				const uint64_t t = _epoch_us + ((_converted + 1) * 1000000) / rate;
+				if (t > us) break;
+				_now_us = t;
+				convert(t);
+				_converted++;
+			}
+		}
+		if (us > _now_us) _now_us = us;
+	}
+
+	uint32_t Max30102Model::to_adc_counts(float level, uint8_t pulse_amplitude) const {
+		const uint8_t spo2 = _regs[REG_SPO2_CONFIG];
+		const float range_na = ADC_RANGE_NA[field(spo2, SPO2_CONF_ADC_RGE_BIT, SPO2_CONF_ADC_RGE_LENGTH)];
+		const uint8_t pw = field(spo2, SPO2_CONF_LED_PW_BIT, SPO2_CONF_LED_PW_LENGTH);
+
+		float counts = level * (pulse_amplitude / REFERENCE_PA) * (REFERENCE_RANGE_NA / range_na);
+		if (counts < 0) counts = 0;
+		uint32_t adc = counts > ADC_MAX ? ADC_MAX : static_cast<uint32_t>(counts);
+
+		// 15 to 18 bit resolution, data stays left justified
+		const uint8_t unused_bits = 3 - pw;
+		adc &= ~((1u << unused_bits) - 1);
+		return adc;
+	}
+
+	void Max30102Model::convert(uint64_t us){
+		const PpgLevel level = _source.sample(us);
+		const uint32_t led1 = to_adc_counts(level.red, _regs[REG_LED1_PA]);
+		const uint32_t led2 = to_adc_counts(level.ir, _regs[REG_LED2_PA]);
+		_stats.produced++;
+
+		_regs[REG_INTR_STATUS_1] |= 1 << INT_PPG_RDY_BIT;
+
+		if (_count == FIFO_DEPTH){
+			if (_ovf_counter < 0x1F) _ovf_counter++;
+			_stats.lost++;
+			if (!(_regs[REG_FIFO_CONFIG] & (1 << FIFO_CONF_FIFO_ROLLOVER_EN_BIT))){
+				update_int_line();
+				return;
+			}
+			// rollover - oldest sample is overwritten
+			_rd_ptr = (_rd_ptr + 1) % FIFO_DEPTH;
+			_byte_index = 0;
+			_count--;
+		}
+
+		uint8_t* slot = _fifo[_wr_ptr];
+		const uint32_t values[2] = {led1, led2};
+		for (uint8_t led = 0; led < 2; led++){
+			slot[led * 3 + 0] = (values[led] >> 16) & 0x03;
+			slot[led * 3 + 1] = (values[led] >> 8) & 0xFF;
+			slot[led * 3 + 2] = values[led] & 0xFF;
+		}
+		_fifo_us[_wr_ptr] = us;
+		_wr_ptr = (_wr_ptr + 1) % FIFO_DEPTH;
+		_count++;
+		if (_count > _stats.max_fill) _stats.max_fill = _count;
+
+		// FIFO_A_FULL holds number of free slots left when interrupt fires
+		const uint8_t a_full = field(_regs[REG_FIFO_CONFIG], FIFO_CONF_FIFO_A_FULL_BIT, FIFO_CONF_FIFO_A_FULL_LENGHT);
+		if (_count >= FIFO_DEPTH - a_full){
+			if (!(_regs[REG_INTR_STATUS_1] & (1 << INT_A_FULL_BIT))) _stats.a_full_events++;
+			_regs[REG_INTR_STATUS_1] |= 1 << INT_A_FULL_BIT;
+		}
+		update_int_line();
+	}
+
+	uint8_t Max30102Model::pop_fifo_byte(void){
+		if (_count == 0){
+			_stats.empty_reads++;
+			return 0;
+		}
+
+		const uint8_t value = _fifo[_rd_ptr][_byte_index];
+		if (++_byte_index == active_leds() * 3){
+			const uint64_t latency = _now_us - _fifo_us[_rd_ptr];
+			_stats.sample_latency_sum_us += latency;
+			if (latency > _stats.sample_latency_max_us) _stats.sample_latency_max_us = latency;
+			_byte_index = 0;
+			_rd_ptr = (_rd_ptr + 1) % FIFO_DEPTH;
+			_count--;
+			_ovf_counter = 0;
+			_stats.popped++;
+		}
+		// FIFO read serves both data flags
+		_regs[REG_INTR_STATUS_1] &= ~((1 << INT_A_FULL_BIT) | (1 << INT_PPG_RDY_BIT));
+		update_int_line();
+		return value;
+	}
+
+	uint8_t Max30102Model::read_register(uint8_t reg){
+		uint8_t value;
+
+		switch (reg){
+			case REG_INTR_STATUS_1:
+				if (_int_line){
+					const uint64_t latency = _now_us - _int_asserted_us;
+					_stats.irq_served++;
+					_stats.irq_latency_sum_us += latency;
+					if (latency > _stats.irq_latency_max_us) _stats.irq_latency_max_us = latency;
+				}
+				[[fallthrough]];
+			case REG_INTR_STATUS_2:
+				value = _regs[reg];
+				_regs[reg] = 0;
+				update_int_line();
+				return value;
+			case REG_FIFO_WR_PTR: return _wr_ptr;
+			case REG_OVF_COUNTER: return _ovf_counter;
+			case REG_FIFO_RD_PTR: return _rd_ptr;
+			case REG_FIFO_DATA: return pop_fifo_byte();
+			default: return _regs[reg];
+		}
+	}
+
+	void Max30102Model::write_register(uint8_t reg, uint8_t value){
+		const uint32_t old_rate = output_rate_hz();
+
+		switch (reg){
+			case REG_INTR_STATUS_1:
+			case REG_INTR_STATUS_2:
+			case REG_FIFO_DATA:
+			case REG_REV_ID:
+			case REG_PART_ID:
+				return;	// read only
+
+			case REG_FIFO_WR_PTR:
+			case REG_FIFO_RD_PTR:
+				if (reg == REG_FIFO_WR_PTR) _wr_ptr = value & 0x1F;
+				else _rd_ptr = value & 0x1F;
+				_count = (_wr_ptr - _rd_ptr) & 0x1F;
+				_byte_index = 0;
+				return;
+
+			case REG_OVF_COUNTER:
+				_ovf_counter = value & 0x1F;
+				return;
+
+			case REG_MODE_CONFIG:
+				if (value & (1 << MODE_RESET_BIT)){
+					// RESET bit clears itself once registers are back to power-on state
+					power_on_reset();
+					return;
+				}
+				break;
+
+			case REG_TEMP_CONFIG:
+				if (value & 0x01){
+					// conversion takes ~29 ms on the part, here it is ready at once
+					_regs[REG_TEMP_INTR] = 25;
+					_regs[REG_TEMP_FRAC] = 0;
+					_regs[REG_INTR_STATUS_2] |= 1 << INT_DIE_TEMP_RDY_BIT;
+					value &= ~0x01;
+				}
+				break;
+		}
+
+		_regs[reg] = value;
+		update_int_line();
+		if (output_rate_hz() != old_rate) restart_sampling(_now_us);
+	}
+
+	bool Max30102Model::mem_read(uint8_t reg, uint8_t* data, uint16_t size){
+		for (uint16_t i = 0; i < size; i++){
+			data[i] = read_register(reg);
+			// register pointer stays on FIFO_DATA, so a burst there drains the FIFO
+			if (reg != REG_FIFO_DATA) reg++;
+		}
+		return true;
+	}
+
+	bool Max30102Model::mem_write(uint8_t reg, const uint8_t* data, uint16_t size){
+		for (uint16_t i = 0; i < size; i++){
+			write_register(reg, data[i]);
+			if (reg != REG_FIFO_DATA) reg++;
+		}
+		return true;
+	}
+
+	void Max30102Model::update_int_line(void){
+		// PWR_RDY can not be masked
+		const uint8_t enable_1 = _regs[REG_INTR_ENABLE_1] | (1 << INT_PWR_RDY_BIT);
+		const bool line = (_regs[REG_INTR_STATUS_1] & enable_1) || (_regs[REG_INTR_STATUS_2] & _regs[REG_INTR_ENABLE_2]);
+		if (line && !_int_line){
+			_int_asserted_us = _now_us;
+			_int_edges++;
+		}
+		_int_line = line;
+	}
+
+	bool Max30102Model::interrupt_asserted(void) const {
+		return _int_line;
+	}
+
+}
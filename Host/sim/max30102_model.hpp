@@ -0,0 +1,104 @@
+/*
+ * max30102_model.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Register level model of MAX30102 on the simulated I2C bus.
+ *
+ *  - register file with power-on values, RESET and SHDN, PART_ID 0x15
+ *  - 32 sample FIFO with FIFO_WR_PTR, OVF_COUNTER and FIFO_RD_PTR, rollover
+ *    on/off, FIFO_DATA reads pop 3 bytes per active LED without address increment
+ *  - A_FULL, PPG_RDY, PWR_RDY and DIE_TEMP_RDY flags, clear on status read,
+ *    INT pin follows enabled flags
+ *  - sample rate from SPO2_CONFIG and SMP_AVE, limited by LED pulse width
+ *  - ADC counts scale with LED current and ADC range, resolution follows pulse width
+ *
+ *  Not modelled: ALC overflow, proximity mode, multi-LED slot config (LED1 + LED2 only).
+ */
+
+#ifndef HOST_SIM_MAX30102_MODEL_HPP_
+#define HOST_SIM_MAX30102_MODEL_HPP_
+
+#include <stdint.h>
+
+#include "sim_i2c.hpp"
+#include "ppg_source.hpp"
+
+namespace sim {
+
+	struct Max30102Stats {
+		uint64_t produced{0};		// samples converted by the device
+		uint64_t popped{0};			// samples read out of FIFO
+		uint64_t lost{0};			// samples dropped on full FIFO (or overwritten with rollover)
+		uint64_t a_full_events{0};
+		uint64_t empty_reads{0};	// FIFO_DATA bytes read with nothing in FIFO
+		uint8_t max_fill{0};
+
+		// INT pin falling edge to INTR_STATUS_1 read
+		uint64_t irq_served{0};
+		uint64_t irq_latency_sum_us{0};
+		uint64_t irq_latency_max_us{0};
+
+		// sample conversion to its last byte read out of FIFO
+		uint64_t sample_latency_sum_us{0};
+		uint64_t sample_latency_max_us{0};
+	};
+
+	class Max30102Model : public I2cDevice {
+	public:
+		static const constexpr uint8_t FIFO_DEPTH = 32;
+		static const constexpr uint8_t PART_ID = 0x15;
+		static const constexpr uint8_t REV_ID = 0x03;
+
+		explicit Max30102Model(PpgSource& source);
+
+		void advance_to(uint64_t us) override;
+		bool mem_read(uint8_t reg, uint8_t* data, uint16_t size) override;
+		bool mem_write(uint8_t reg, const uint8_t* data, uint16_t size) override;
+
+		// INT pin is open drain active low, true means pulled low
+		bool interrupt_asserted(void) const;
+		// falling edges so far - EXTI stand-ins compare it, polling the level misses short highs
+		uint64_t interrupt_edges(void) const { return _int_edges; }
+
+		// effective rate after averaging and pulse width limit, 0 when not sampling
+		uint32_t output_rate_hz(void) const;
+		uint8_t fifo_fill(void) const { return _count; }
+		const Max30102Stats& stats(void) const { return _stats; }
+
+	private:
+		void power_on_reset(void);
+		uint8_t read_register(uint8_t reg);
+		void write_register(uint8_t reg, uint8_t value);
+		void restart_sampling(uint64_t us);
+		void convert(uint64_t us);
+		uint32_t to_adc_counts(float level, uint8_t pulse_amplitude) const;
+		uint8_t active_leds(void) const;
+		uint8_t pop_fifo_byte(void);
+		void update_int_line(void);
+
+		PpgSource& _source;
+		uint8_t _regs[256];
+
+		uint8_t _fifo[FIFO_DEPTH][6];
+		uint64_t _fifo_us[FIFO_DEPTH];	// conversion time of each slot
+		uint8_t _wr_ptr;
+		uint8_t _rd_ptr;
+		uint8_t _ovf_counter;
+		uint8_t _count;			// unread samples, tells full from empty when pointers are equal
+		uint8_t _byte_index;	// position inside the sample being read from FIFO_DATA
+
+		bool _int_line;
+		uint64_t _int_asserted_us;
+		uint64_t _int_edges;
+
+		uint64_t _now_us;
+		uint64_t _epoch_us;		// time of sample 0 since last rate change
+		uint64_t _converted;	// samples since _epoch_us
+		Max30102Stats _stats;
+	};
+
+}
+
+#endif /* HOST_SIM_MAX30102_MODEL_HPP_ */
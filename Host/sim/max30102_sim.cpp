@@ -0,0 +1,266 @@
+/*
+ * max30102_sim.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Runs unmodified Core/Src/MAX30102/MAX30102.cpp against Max30102Model on
+ *  simulated time. Mirrors main.cpp task layout: acquisition task serves
+ *  INT falling edges with Max30102_InterruptCallback, max30102 task calls
+ *  Max30102_Task every --task-ms.
+ *
+ *  usage: max30102_sim [--csv file.csv [--csv-sps N] | --bpm N] [--seconds N]
+ *                      [--task-ms N] [--latency-ms N] [--stall-every-ms N --stall-ms N]
+ *                      [--finger-off S:D] [--rollover] [--dma] [--quiet]
+ *
+ *  --latency-ms     delay between INT edge and acquisition task running
+ *  --stall-every-ms acquisition task is blocked for --stall-ms every N ms,
+ *                   stands in for higher priority load - use it for FIFO overflow runs
+ *  --finger-off S:D synthetic source reads ambient light from S to S+D seconds
+ *  --rollover       sets FIFO_ROLLOVER_EN after init, default is driver setting (off)
+ *  --dma            attaches DMA handle to hi2c1, driver switches to HAL_I2C_Mem_Read_DMA
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "main.h"
+#include "i2c.h"
+#include "MAX30102/MAX30102.hpp"
+
+#include "sim_clock.hpp"
+#include "sim_i2c.hpp"
+#include "max30102_model.hpp"
+#include "ppg_source.hpp"
+#include "ppg_csv.hpp"
+
+I2C_HandleTypeDef hi2c1;
+static DMA_HandleTypeDef hdma_i2c1_rx;
+
+void Error_Handler(void)
+{
+	fprintf(stderr, "Error_Handler\n");
+	exit(1);
+}
+
+extern "C" void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	if (hi2c == &hi2c1)
+	{
+		Max30102_FifoDmaCompleteCallback();
+	}
+}
+
+extern "C" void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	if (hi2c == &hi2c1)
+	{
+		Max30102_FifoDmaErrorCallback();
+	}
+}
+
+namespace {
+
+using wall_clock = std::chrono::steady_clock;
+
+// simulation step, well below the shortest sample period (312 us at 3200 SPS)
+static const constexpr uint64_t STEP_US = 50;
+
+struct Options {
+	const char* csv{nullptr};
+	uint32_t csv_sps{MAX30102_SAMPLES_PER_SECOND};
+	float bpm{72.0f};
+	uint32_t seconds{60};
+	uint32_t task_ms{50};
+	uint32_t latency_ms{0};
+	uint32_t stall_every_ms{0};
+	uint32_t stall_ms{0};
+	float finger_off_s{0};
+	float finger_off_len_s{0};
+	bool rollover{false};
+	bool dma{false};
+	bool quiet{false};
+};
+
+bool parse_options(int argc, char** argv, Options& opt){
+	for (int i{1}; i < argc; i++){
+		const bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "--csv") && has_value) opt.csv = argv[++i];
+		else if (!strcmp(argv[i], "--csv-sps") && has_value) opt.csv_sps = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--bpm") && has_value) opt.bpm = strtof(argv[++i], nullptr);
+		else if (!strcmp(argv[i], "--seconds") && has_value) opt.seconds = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--task-ms") && has_value) opt.task_ms = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--latency-ms") && has_value) opt.latency_ms = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--stall-every-ms") && has_value) opt.stall_every_ms = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--stall-ms") && has_value) opt.stall_ms = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--finger-off") && has_value){
+			if (sscanf(argv[++i], "%f:%f", &opt.finger_off_s, &opt.finger_off_len_s) != 2) return false;
+		}
+		else if (!strcmp(argv[i], "--rollover")) opt.rollover = true;
+		else if (!strcmp(argv[i], "--dma")) opt.dma = true;
+		else if (!strcmp(argv[i], "--quiet")) opt.quiet = true;
+		else return false;
+	}
+	return opt.task_ms > 0 && opt.csv_sps > 0 && opt.bpm > 0;
+}
+
+struct CallTiming {
+	uint64_t calls{0};
+	uint64_t total_ns{0};
+	uint64_t max_ns{0};
+	uint64_t sim_us{0};		// simulated time spent inside, bus transfers and timeouts
+
+	template<typename F>
+	void run(F function){
+		const uint64_t sim_start = sim::Clock::now_us();
+		const auto start = wall_clock::now();
+		function();
+		const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wall_clock::now() - start).count();
+		calls++;
+		total_ns += ns;
+		if (ns > max_ns) max_ns = ns;
+		sim_us += sim::Clock::now_us() - sim_start;
+	}
+
+	void report(const char* name) const {
+		fprintf(stderr, "  %-28s %8llu calls, host %8.0f ns mean, %8llu ns max, bus/timeout %6.1f us mean\n",
+				name, static_cast<unsigned long long>(calls),
+				calls ? static_cast<double>(total_ns) / calls : 0.0,
+				static_cast<unsigned long long>(max_ns),
+				calls ? static_cast<double>(sim_us) / calls : 0.0);
+	}
+};
+
+bool stalled(const Options& opt, uint64_t now_us){
+	if (opt.stall_every_ms == 0 || opt.stall_ms == 0) return false;
+	return (now_us / 1000) % opt.stall_every_ms < opt.stall_ms;
+}
+
+}
+
+int main(int argc, char** argv){
+	Options opt{};
+	if (!parse_options(argc, argv, opt)){
+		fprintf(stderr, "usage: %s [--csv file.csv [--csv-sps N] | --bpm N] [--seconds N] [--task-ms N] [--latency-ms N]\n"
+				"       [--stall-every-ms N --stall-ms N] [--finger-off S:D] [--rollover] [--dma] [--quiet]\n", argv[0]);
+		return 2;
+	}
+
+	static PpgRecording rec{};
+	sim::SyntheticPpgSource::Config synth_cfg{};
+	synth_cfg.bpm = opt.bpm;
+	synth_cfg.finger_off_us = static_cast<uint64_t>(opt.finger_off_s * 1e6f);
+	synth_cfg.finger_off_len_us = static_cast<uint64_t>(opt.finger_off_len_s * 1e6f);
+	sim::SyntheticPpgSource synthetic{synth_cfg};
+	sim::PpgSource* source = &synthetic;
+
+	if (opt.csv != nullptr){
+		if (!load_ppg_csv(opt.csv, opt.csv_sps, rec)){
+			fprintf(stderr, "no samples in %s\n", opt.csv);
+			return 1;
+		}
+		static sim::CsvPpgSource csv_source{rec};
+		source = &csv_source;
+	}
+
+	static sim::Max30102Model sensor{*source};
+	sim::Clock::reset();
+	sim::I2cBus::detach_all();
+	sim::I2cBus::attach(MAX30102_ADDRESS, &sensor);
+
+	hi2c1.Instance = I2C1;
+	hi2c1.Init.ClockSpeed = 400000;
+	hi2c1.hdmarx = opt.dma ? &hdma_i2c1_rx : NULL;
+
+	CallTiming init_timing{}, irq_timing{}, task_timing{};
+	MAX30102_STATUS status{MAX30102_ERROR};
+	init_timing.run([&]{ status = Max30102_Init(&hi2c1); });
+	if (status != MAX30102_OK){
+		fprintf(stderr, "Max30102_Init failed\n");
+		return 1;
+	}
+	if (opt.rollover) Max30102_FifoRolloverEnable(1);
+
+	// same as acquisition task - INT may already be low before first edge
+	irq_timing.run([]{ Max30102_InterruptCallback(); });
+
+	const uint64_t end_us = static_cast<uint64_t>(opt.seconds) * 1000000;
+	uint64_t next_task_us = sim::Clock::now_us();
+	uint64_t notified_us{0};
+	bool notified{false};
+	uint64_t seen_edges{sensor.interrupt_edges()};
+	uint32_t hr_updates{0}, hr_valid{0}, last_hr{0};
+	float hr_sum{0};
+
+	if (!opt.quiet) printf("ts_ms,hr\n");
+
+	const auto wall_start = wall_clock::now();
+	while (sim::Clock::now_us() < end_us){
+		const uint64_t now = sim::Clock::now_us();
+		sensor.advance_to(now);
+
+		// EXTI on falling edge only, task notification does not count edges
+		if (sensor.interrupt_edges() != seen_edges){
+			seen_edges = sensor.interrupt_edges();
+			if (!notified){
+				notified = true;
+				notified_us = now;
+			}
+		}
+
+		if (notified && !stalled(opt, now) && now >= notified_us + opt.latency_ms * 1000ull){
+			notified = false;
+			irq_timing.run([]{ Max30102_InterruptCallback(); });
+		}
+
+		if (sim::Clock::now_us() >= next_task_us){
+			task_timing.run([]{ Max30102_Task(); });
+			next_task_us += opt.task_ms * 1000ull;
+
+			const uint32_t hr = get_hr();
+			if (hr != last_hr){
+				last_hr = hr;
+				hr_updates++;
+				if (hr != 0){
+					hr_sum += hr;
+					hr_valid++;
+				}
+				if (!opt.quiet) printf("%u,%d\n", sim::Clock::now_ms(), int(hr));
+			}
+		}
+
+		sim::Clock::advance_to(now + STEP_US);
+	}
+	const double wall_s = std::chrono::duration<double>(wall_clock::now() - wall_start).count();
+	const double sim_s = sim::Clock::now_us() / 1e6;
+
+	const auto& dev = sensor.stats();
+	const auto& bus = sim::I2cBus::stats();
+
+	fprintf(stderr, "simulated %.1f s in %.3f s wall (%.0fx real time), source %s, %s reads\n",
+			sim_s, wall_s, sim_s / wall_s, opt.csv ? opt.csv : "synthetic", opt.dma ? "DMA" : "blocking");
+	fprintf(stderr, "sensor: %u SPS, %llu produced, %llu read, %llu lost (%.2f%%), %llu A_FULL, max fill %u/%u, %llu empty FIFO reads\n",
+			sensor.output_rate_hz(),
+			static_cast<unsigned long long>(dev.produced), static_cast<unsigned long long>(dev.popped),
+			static_cast<unsigned long long>(dev.lost), dev.produced ? 100.0 * dev.lost / dev.produced : 0.0,
+			static_cast<unsigned long long>(dev.a_full_events), dev.max_fill, sim::Max30102Model::FIFO_DEPTH,
+			static_cast<unsigned long long>(dev.empty_reads));
+	fprintf(stderr, "latency: INT edge to status read %.0f us mean, %llu us max; sample to read %.0f us mean, %llu us max\n",
+			dev.irq_served ? static_cast<double>(dev.irq_latency_sum_us) / dev.irq_served : 0.0,
+			static_cast<unsigned long long>(dev.irq_latency_max_us),
+			dev.popped ? static_cast<double>(dev.sample_latency_sum_us) / dev.popped : 0.0,
+			static_cast<unsigned long long>(dev.sample_latency_max_us));
+	fprintf(stderr, "i2c: %llu transfers, %llu bytes, bus busy %.2f%%, %llu NACK\n",
+			static_cast<unsigned long long>(bus.transfers), static_cast<unsigned long long>(bus.bytes),
+			100.0 * bus.busy_us / sim::Clock::now_us(), static_cast<unsigned long long>(bus.nacks));
+	init_timing.report("Max30102_Init");
+	irq_timing.report("Max30102_InterruptCallback");
+	task_timing.report("Max30102_Task");
+	fprintf(stderr, "hr: %u changes (%u non-zero), mean %.1f bpm", hr_updates, hr_valid, hr_valid ? hr_sum / hr_valid : 0.0f);
+	if (opt.csv == nullptr) fprintf(stderr, ", source %.1f bpm", opt.bpm);
+	fprintf(stderr, "\n");
+	return 0;
+}
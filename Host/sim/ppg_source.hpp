@@ -0,0 +1,93 @@
+/*
+ * ppg_source.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Optical signal seen by the simulated MAX30102. Levels are ADC counts at
+ *  reference LED current (MAX30102_IR_LED_CURRENT_HIGH), 4096 nA range and
+ *  18 bit resolution - the settings of recordings in scripts/.
+ */
+
+#ifndef HOST_SIM_PPG_SOURCE_HPP_
+#define HOST_SIM_PPG_SOURCE_HPP_
+
+#include <stdint.h>
+#include <math.h>
+
+#include "ppg_csv.hpp"
+
+namespace sim {
+
+	struct PpgLevel {
+		float ir;
+		float red;
+	};
+
+	class PpgSource {
+	public:
+		virtual ~PpgSource(){};
+		virtual PpgLevel sample(uint64_t t_us) = 0;
+	};
+
+	// recording replayed in a loop, linear interpolation between recorded samples
+	class CsvPpgSource : public PpgSource {
+	public:
+		explicit CsvPpgSource(const PpgRecording& rec) : _rec{rec}, _index{0} {};
+
+		PpgLevel sample(uint64_t t_us) override {
+			const auto& s = _rec.samples;
+			const int32_t period_ms = _rec.duration_ms;
+			const float t_ms = static_cast<float>(t_us % (static_cast<uint64_t>(period_ms) * 1000)) / 1000.0f;
+
+			// time moves forward, search continues from last position
+			if (t_ms < s[_index].ts) _index = 0;
+			while (_index + 1 < s.size() && s[_index + 1].ts <= t_ms) _index++;
+
+			if (_index + 1 >= s.size()) return {static_cast<float>(s[_index].ir), static_cast<float>(s[_index].red)};
+
+			const auto& a = s[_index];
+			const auto& b = s[_index + 1];
+			const float k = (t_ms - a.ts) / static_cast<float>(b.ts - a.ts);
+			return {a.ir + k * (b.ir - a.ir), a.red + k * (b.red - a.red)};
+		}
+
+	private:
+		const PpgRecording& _rec;
+		size_t _index;
+	};
+
+	// pulse with dicrotic notch on top of a DC level, finger can be taken off for a while
+	class SyntheticPpgSource : public PpgSource {
+	public:
+		struct Config {
+			float bpm{72.0f};
+			float dc_ir{65000.0f};
+			float dc_red{64000.0f};
+			float ac_ir{600.0f};	// peak to peak
+			float ac_red{400.0f};
+			uint64_t finger_off_us{0};	// finger off window start, 0 - never
+			uint64_t finger_off_len_us{0};
+		};
+
+		explicit SyntheticPpgSource(const Config& cfg) : _cfg{cfg} {};
+
+		PpgLevel sample(uint64_t t_us) override {
+			if (_cfg.finger_off_len_us != 0 && t_us >= _cfg.finger_off_us && t_us < _cfg.finger_off_us + _cfg.finger_off_len_us)
+				return {AMBIENT, AMBIENT};
+
+			const float t = t_us / 1e6f;
+			const float phase = 2.0f * static_cast<float>(M_PI) * (_cfg.bpm / 60.0f) * t;
+			// blood volume rises on systole, so reflected light drops
+			const float pulse = 0.5f * (sinf(phase) + 0.35f * sinf(2.0f * phase + 0.8f));
+			return {_cfg.dc_ir - _cfg.ac_ir * pulse, _cfg.dc_red - _cfg.ac_red * pulse};
+		}
+
+	private:
+		static const constexpr float AMBIENT = 300.0f;
+		Config _cfg;
+	};
+
+}
+
+#endif /* HOST_SIM_PPG_SOURCE_HPP_ */
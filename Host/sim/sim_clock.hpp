@@ -0,0 +1,58 @@
+/*
+ * sim_clock.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Time base of the simulated peripherals, in microseconds.
+ *  Simulated mode (default) - only the harness and bus transfers move it,
+ *  so runs are deterministic and independent of host speed.
+ *  Wall mode (FreeRTOS POSIX build) - follows steady_clock, a bus transfer
+ *  holds the calling thread for its duration like a blocking HAL call.
+ */
+
+#ifndef HOST_SIM_SIM_CLOCK_HPP_
+#define HOST_SIM_SIM_CLOCK_HPP_
+
+#include <stdint.h>
+#include <chrono>
+#include <thread>
+
+namespace sim {
+
+	class Clock {
+	public:
+		static uint64_t now_us(void) {
+			if (!_wall) return _now_us;
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _wall_start).count();
+		}
+
+		static uint32_t now_ms(void) { return static_cast<uint32_t>(now_us() / 1000); }
+
+		static void advance_us(uint64_t us) {
+			if (_wall) std::this_thread::sleep_for(std::chrono::microseconds(us));
+			else _now_us += us;
+		}
+
+		// never goes back, bus transfers may already be past target
+		static void advance_to(uint64_t us) { if (!_wall && us > _now_us) _now_us = us; }
+
+		static void reset(void) {
+			_now_us = 0;
+			_wall_start = std::chrono::steady_clock::now();
+		}
+
+		static void use_wall_time(bool wall) {
+			_wall = wall;
+			reset();
+		}
+
+	private:
+		static inline bool _wall{false};
+		static inline uint64_t _now_us{0};
+		static inline std::chrono::steady_clock::time_point _wall_start{};
+	};
+
+}
+
+#endif /* HOST_SIM_SIM_CLOCK_HPP_ */
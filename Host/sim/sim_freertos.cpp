@@ -0,0 +1,73 @@
+/*
+ * sim_freertos.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Single threaded FreeRTOS stand-in, see stubs/semphr.h.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "sim_clock.hpp"
+
+struct SimSemaphore {
+	UBaseType_t count;
+	UBaseType_t max_count;
+};
+
+namespace {
+
+	SemaphoreHandle_t create(UBaseType_t count, UBaseType_t max_count){
+		return new SimSemaphore{count, max_count};
+	}
+
+}
+
+extern "C" {
+
+TickType_t xTaskGetTickCount(void)
+{
+	return static_cast<TickType_t>(sim::Clock::now_ms());
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+	return create(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+	return create(0, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime)
+{
+	if(xSemaphore->count == 0)
+	{
+		// nobody else can give it meanwhile, the whole timeout passes
+		if(xBlockTime != portMAX_DELAY)
+			sim::Clock::advance_us(static_cast<uint64_t>(xBlockTime) * 1000);
+		return pdFALSE;
+	}
+	xSemaphore->count--;
+	return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+	if(xSemaphore->count >= xSemaphore->max_count)
+		return pdFALSE;
+	xSemaphore->count++;
+	return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t xSemaphore, BaseType_t *pxHigherPriorityTaskWoken)
+{
+	if(pxHigherPriorityTaskWoken != NULL)
+		*pxHigherPriorityTaskWoken = pdFALSE;
+	return xSemaphoreGive(xSemaphore);
+}
+
+}
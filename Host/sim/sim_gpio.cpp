@@ -0,0 +1,43 @@
+/*
+ * sim_gpio.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ */
+
+#include "main.h"
+#include "sim_gpio.hpp"
+
+GPIO_TypeDef SimGPIOA;
+GPIO_TypeDef SimGPIOC;
+
+extern "C" {
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	if(PinState == GPIO_PIN_SET)
+		GPIOx->ODR |= GPIO_Pin;
+	else
+		GPIOx->ODR &= ~GPIO_Pin;
+	sim::Gpio::notify(GPIOx, GPIO_Pin, PinState);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	HAL_GPIO_WritePin(GPIOx, GPIO_Pin, (GPIOx->ODR & GPIO_Pin) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+void MX_GPIO_Init(void)
+{
+	SimGPIOA.IDR = MAX_INT_Pin;	// INT is open drain with pull-up, idle high
+	SimGPIOA.ODR = 0;
+	SimGPIOC.IDR = 0;
+	SimGPIOC.ODR = 0;
+}
+
+}
@@ -0,0 +1,35 @@
+/*
+ * sim_gpio.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Output pin observer for HAL_GPIO_* stand-ins. Harness sets it to
+ *  timestamp pin changes (debug LED period, scheduling jitter).
+ */
+
+#ifndef HOST_SIM_SIM_GPIO_HPP_
+#define HOST_SIM_SIM_GPIO_HPP_
+
+#include <stdint.h>
+
+#include "main.h"
+
+namespace sim {
+
+	class Gpio {
+	public:
+		using Observer = void (*)(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state);
+
+		static void set_observer(Observer observer) { _observer = observer; }
+		static void notify(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state) {
+			if (_observer != nullptr) _observer(port, pin, state);
+		}
+
+	private:
+		static inline Observer _observer{nullptr};
+	};
+
+}
+
+#endif /* HOST_SIM_SIM_GPIO_HPP_ */
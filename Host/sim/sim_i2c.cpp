@@ -0,0 +1,146 @@
+/*
+ * sim_i2c.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  HAL_I2C_* stand-ins routed to sim::I2cBus. DMA reads complete inline and
+ *  report through HAL_I2C_MemRxCpltCallback like the real IRQ handler would.
+ */
+
+#include "main.h"
+#include "sim_clock.hpp"
+#include "sim_i2c.hpp"
+
+namespace sim {
+
+	bool I2cBus::attach(uint16_t address, I2cDevice* device){
+		for (auto& slot : _slots){
+			if (slot.device == nullptr){
+				slot = {address, device};
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void I2cBus::detach_all(void){
+		for (auto& slot : _slots) slot = {0, nullptr};
+		_stats = {};
+	}
+
+	I2cDevice* I2cBus::find(uint16_t address){
+		for (auto& slot : _slots){
+			if (slot.device != nullptr && slot.address == address) return slot.device;
+		}
+		return nullptr;
+	}
+
+	uint64_t I2cBus::transfer_us(uint32_t clock_hz, uint16_t mem_size, uint16_t size, bool read){
+		// 9 clocks per byte (8 data + ACK), ~1 clock each for start, repeated start and stop
+		uint64_t clocks = 9 * (1 + mem_size + size) + 2;
+		if (read) clocks += 9 + 1;
+		if (clock_hz == 0) clock_hz = 100000;
+		return (clocks * 1000000 + clock_hz - 1) / clock_hz;
+	}
+
+}
+
+I2C_TypeDef SimI2C1;
+
+namespace {
+
+	HAL_StatusTypeDef mem_transfer(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+			uint16_t MemAddSize, uint8_t *pData, uint16_t Size, bool read){
+		auto& stats = sim::I2cBus::stats();
+		const uint64_t us = sim::I2cBus::transfer_us(hi2c->Init.ClockSpeed, MemAddSize, Size, read);
+		bool ack{false};
+
+		{
+			std::lock_guard<std::mutex> lock(sim::I2cBus::mutex());
+			stats.transfers++;
+			stats.bytes += Size;
+			stats.busy_us += us;
+
+			sim::I2cDevice* device = sim::I2cBus::find(DevAddress);
+			if (device != nullptr){
+				device->advance_to(sim::Clock::now_us());
+				ack = read ? device->mem_read(static_cast<uint8_t>(MemAddress), pData, Size)
+						: device->mem_write(static_cast<uint8_t>(MemAddress), pData, Size);
+			}
+		}
+		// data moves at once, the caller still waits the whole transfer
+		sim::Clock::advance_us(us);
+
+		if (!ack){
+			stats.nacks++;
+			hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+			return HAL_ERROR;
+		}
+		hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+		return HAL_OK;
+	}
+
+}
+
+extern "C" {
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)Timeout;
+	return mem_transfer(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, false);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)Timeout;
+	return mem_transfer(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, true);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	if(hi2c->hdmarx == NULL)
+		return HAL_ERROR;
+
+	if(HAL_OK == mem_transfer(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, true))
+		HAL_I2C_MemRxCpltCallback(hi2c);
+	else
+		HAL_I2C_ErrorCallback(hi2c);
+	return HAL_OK;
+}
+
+// DMA reads complete inline, so there is never a transfer to abort
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c)
+{
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+	(void)hdma;
+	return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+}
+
+__attribute__((weak)) void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+}
+
+uint32_t HAL_GetTick(void)
+{
+	return sim::Clock::now_ms();
+}
+
+}
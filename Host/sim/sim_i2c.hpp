@@ -0,0 +1,68 @@
+/*
+ * sim_i2c.hpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Simulated I2C bus behind HAL_I2C_Mem_* stand-ins. Every transfer
+ *  costs simulated bus time at hi2c->Init.ClockSpeed.
+ */
+
+#ifndef HOST_SIM_SIM_I2C_HPP_
+#define HOST_SIM_SIM_I2C_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+
+namespace sim {
+
+	class I2cDevice {
+	public:
+		virtual ~I2cDevice(){};
+
+		// called before every transfer, device catches up with simulated time
+		virtual void advance_to(uint64_t us) = 0;
+		// false means NACK
+		virtual bool mem_read(uint8_t reg, uint8_t* data, uint16_t size) = 0;
+		virtual bool mem_write(uint8_t reg, const uint8_t* data, uint16_t size) = 0;
+	};
+
+	struct I2cBusStats {
+		uint64_t transfers{0};
+		uint64_t bytes{0};
+		uint64_t busy_us{0};
+		uint64_t nacks{0};
+	};
+
+	class I2cBus {
+	public:
+		static const constexpr size_t MAX_DEVICES = 4;
+
+		// address in HAL 8-bit form, as passed to HAL_I2C_Mem_Read
+		static bool attach(uint16_t address, I2cDevice* device);
+		static void detach_all(void);
+		static I2cDevice* find(uint16_t address);
+
+		// start + address + register + repeated start + address + data + stop
+		static uint64_t transfer_us(uint32_t clock_hz, uint16_t mem_size, uint16_t size, bool read);
+
+		static I2cBusStats& stats(void) { return _stats; }
+
+		// held while a device is accessed, simulated interrupt sources take it too
+		static std::mutex& mutex(void) { return _mutex; }
+
+	private:
+		struct Slot {
+			uint16_t address;
+			I2cDevice* device;
+		};
+
+		static inline Slot _slots[MAX_DEVICES]{};
+		static inline I2cBusStats _stats{};
+		static inline std::mutex _mutex{};
+	};
+
+}
+
+#endif /* HOST_SIM_SIM_I2C_HPP_ */
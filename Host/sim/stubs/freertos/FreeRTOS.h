@@ -0,0 +1,34 @@
+/*
+ * FreeRTOS.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Single threaded host stand-in for the FreeRTOS API used by the MAX30102 driver.
+ *  Tick count follows simulated time (sim::Clock), 1 tick = 1 ms as in FreeRTOSConfig.h.
+ */
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define configTICK_RATE_HZ		((TickType_t)1000)
+
+#define pdFALSE		((BaseType_t)0)
+#define pdTRUE		((BaseType_t)1)
+#define pdPASS		(pdTRUE)
+#define pdFAIL		(pdFALSE)
+
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000))
+#define portMAX_DELAY	((TickType_t)0xffffffffUL)
+
+// nothing to switch to, ISR callbacks run inline
+#define portYIELD_FROM_ISR(x)	((void)(x))
+
+#endif /* INC_FREERTOS_H */
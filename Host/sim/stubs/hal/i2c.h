@@ -0,0 +1,25 @@
+/*
+ * i2c.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Host stand-in for Core/Inc/i2c.h, hi2c1 is defined by the simulation harness.
+ */
+
+#ifndef __I2C_H__
+#define __I2C_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+extern I2C_HandleTypeDef hi2c1;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __I2C_H__ */
@@ -0,0 +1,32 @@
+/*
+ * main.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Host stand-in for Core/Inc/main.h.
+ */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include "MAX30102/MAX30102.hpp"
+
+void Error_Handler(void);
+
+#define DB_LED_Pin GPIO_PIN_13
+#define DB_LED_GPIO_Port GPIOC
+#define MAX_INT_Pin GPIO_PIN_15
+#define MAX_INT_GPIO_Port GPIOA
+#define MAX_INT_EXTI_IRQn EXTI15_10_IRQn
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
@@ -0,0 +1,106 @@
+/*
+ * stm32f4xx_hal.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Host stand-in for the parts of STM32F4 HAL used by the MAX30102 driver.
+ *  I2C transfers are served by sim::I2cBus (Host/sim/sim_i2c.hpp),
+ *  GPIO by Host/sim/sim_gpio.cpp.
+ */
+
+#ifndef HOST_SIM_STM32F4XX_HAL_H_
+#define HOST_SIM_STM32F4XX_HAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+  GPIO_PIN_RESET = 0,
+  GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+  volatile uint32_t IDR;
+  volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  volatile uint32_t CR1;
+} I2C_TypeDef;
+
+extern GPIO_TypeDef SimGPIOA;
+extern GPIO_TypeDef SimGPIOC;
+extern I2C_TypeDef SimI2C1;
+
+#define GPIOA   (&SimGPIOA)
+#define GPIOC   (&SimGPIOC)
+#define I2C1    (&SimI2C1)
+
+#define GPIO_PIN_13   ((uint16_t)0x2000)
+#define GPIO_PIN_15   ((uint16_t)0x8000)
+
+typedef enum
+{
+  EXTI15_10_IRQn = 40
+} IRQn_Type;
+
+typedef struct
+{
+  uint32_t Channel;
+} DMA_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t ClockSpeed;
+} I2C_InitTypeDef;
+
+typedef struct
+{
+  I2C_TypeDef        *Instance;
+  I2C_InitTypeDef    Init;
+  DMA_HandleTypeDef  *hdmatx;
+  DMA_HandleTypeDef  *hdmarx;
+  uint32_t           ErrorCode;
+} I2C_HandleTypeDef;
+
+#define HAL_I2C_ERROR_NONE  0x00000000U
+#define HAL_I2C_ERROR_AF    0x00000004U
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+uint32_t HAL_GetTick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_SIM_STM32F4XX_HAL_H_ */
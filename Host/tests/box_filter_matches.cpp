@@ -0,0 +1,89 @@
+/*
+ * box_filter_matches.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Checks that convolution with box_window gives the same output, bit for
+ *  bit, as the generic convolution with an etl::array of ones, and that both
+ *  match a reference with int64 sums and signed division. Each signal is a
+ *  PPG-like waveform with a level subtracted: raw (~60000 counts), centred
+ *  on zero and entirely negative, so the sums go below zero too.
+ *  Exits non-zero on the first mismatch.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "algo_utils.hpp"
+
+namespace {
+
+static const constexpr int32_t LEVELS[] = {0, 60000, 120000};
+
+// 75 bpm pulse, respiration wander and LCG noise at 100 sps, minus level
+template<size_t SIZE>
+void make_signal(etl::array<int32_t, SIZE>& signal, int32_t level){
+	uint32_t lcg{12345};
+	for (size_t i{0}; i < SIZE; i++){
+		const float t = i / 100.0f;
+		lcg = lcg * 1664525u + 1013904223u;
+		const float noise = static_cast<float>(lcg >> 24) - 128.0f;
+		const float pulse = 600.0f * sinf(2.0f * M_PI * 1.25f * t) + 200.0f * sinf(4.0f * M_PI * 1.25f * t);
+		const float resp = 300.0f * sinf(2.0f * M_PI * 0.25f * t);
+		signal[i] = static_cast<int32_t>(60000.0f + pulse + resp + noise) - level;
+	}
+}
+
+// in place semantics of convolution - mean of the window starting at i, tail holds the last full window
+template<size_t WINDOW, size_t SIZE>
+void reference(const etl::array<int32_t, SIZE>& input, etl::array<int32_t, SIZE>& output){
+	for (size_t i{0}; i < SIZE - WINDOW; i++){
+		int64_t sum{0};
+		for (size_t j{0}; j < WINDOW; j++) sum += input[i + j];
+		output[i] = static_cast<int32_t>(sum / static_cast<int64_t>(WINDOW));
+	}
+	for (size_t i{SIZE - WINDOW}; i < SIZE; i++) output[i] = output[SIZE - WINDOW - 1];
+}
+
+template<size_t WINDOW, size_t SIZE>
+bool matches(int32_t level){
+	static etl::array<int32_t, SIZE> input, expected, generic, box;
+	etl::array<int32_t, WINDOW> ones;
+	ones.fill(1);
+
+	make_signal(input, level);
+	reference<WINDOW>(input, expected);
+	generic = input;
+	box = input;
+	algo::utils::convolution(ones, generic);
+	algo::utils::convolution(algo::utils::box_window<int32_t, WINDOW>{}, box);
+
+	for (size_t i{0}; i < SIZE; i++){
+		if (generic[i] != expected[i] || box[i] != expected[i]){
+			fprintf(stderr, "window %zu, size %zu, level %d: at %zu reference %d, generic %d, box %d\n",
+					WINDOW, SIZE, level, i, expected[i], generic[i], box[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+template<size_t WINDOW, size_t SIZE>
+bool matches_all_levels(void){
+	for (const int32_t level : LEVELS){
+		if (!matches<WINDOW, SIZE>(level)) return false;
+	}
+	return true;
+}
+
+}
+
+int main(void){
+	const bool ok = matches_all_levels<2, 200>() && matches_all_levels<5, 200>() &&
+			matches_all_levels<11, 600>() && matches_all_levels<11, 1200>() && matches_all_levels<25, 1200>();
+	if (!ok) return 1;
+	printf("box_window convolution matches generic convolution and reference\n");
+	return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * gradient_sums_match.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Builds the M4 DSP branch of algo::utils::replace_in_sums on host, with
+ *  PKHBT, SMUSD and SMLSLD emulated as the Armv7E-M manual defines them, and
+ *  checks it bit for bit against the plain branch over random gradients and
+ *  the clamp limits. GradientWindow, which takes the DSP branch here, is
+ *  checked against a standard deviation recomputed over its last values.
+ *  Exits non-zero on the first mismatch.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+// halfword arithmetic of the instructions, stands in for cmsis_gcc.h
+#define __PKHBT(ARG1, ARG2, ARG3) ((((uint32_t)(ARG1)) & 0x0000FFFFUL) | ((((uint32_t)(ARG2)) << (ARG3)) & 0xFFFF0000UL))
+
+static inline int32_t low_half(uint32_t word){ return static_cast<int16_t>(word & 0xFFFF); }
+static inline int32_t high_half(uint32_t word){ return static_cast<int16_t>(word >> 16); }
+
+static inline uint32_t __SMUSD(uint32_t op1, uint32_t op2){
+	return static_cast<uint32_t>(low_half(op1) * low_half(op2) - high_half(op1) * high_half(op2));
+}
+
+static inline uint64_t __SMLSLD(uint32_t op1, uint32_t op2, uint64_t acc){
+	const int64_t product = static_cast<int64_t>(low_half(op1)) * low_half(op2) -
+			static_cast<int64_t>(high_half(op1)) * high_half(op2);
+	return acc + static_cast<uint64_t>(product);
+}
+
+#define ALGO_DSP_INTRINSICS 1
+#include "algo_utils.hpp"
+#include "hr_stages.hpp"
+
+namespace {
+
+static const constexpr int32_t LIMIT = static_cast<int32_t>(algo::design::MAX_GRADIENT) - 1;
+
+struct Lcg{
+	uint32_t state{12345};
+	uint32_t next(void){
+		state = state * 1664525u + 1013904223u;
+		return state;
+	}
+	// clamped gradient, every 8th one at a limit or zero as clamped_slope leaves them
+	int32_t gradient(void){
+		const uint32_t r = next();
+		switch (r & 7){
+		case 0: return (r & 8) ? LIMIT : -LIMIT;
+		case 1: return 0;
+		default: return static_cast<int32_t>((r >> 8) % (2 * LIMIT + 1)) - LIMIT;
+		}
+	}
+};
+
+bool kernel_matches(uint32_t updates){
+	Lcg lcg;
+	int64_t plain_sum{0}, plain_sq_sum{0}, dsp_sum{0}, dsp_sq_sum{0};
+	for (uint32_t i{0}; i < updates; i++){
+		const int32_t value = lcg.gradient();
+		// every 4th update a window still filling, nothing leaves
+		const int32_t oldest = (i & 3) ? lcg.gradient() : 0;
+		algo::utils::replace_in_sums_plain(value, oldest, plain_sum, plain_sq_sum);
+		algo::utils::replace_in_sums_dsp(value, oldest, dsp_sum, dsp_sq_sum);
+		if (plain_sum != dsp_sum || plain_sq_sum != dsp_sq_sum){
+			fprintf(stderr, "update %u (%d in, %d out): plain %lld / %lld, dsp %lld / %lld\n", i, value, oldest,
+					static_cast<long long>(plain_sum), static_cast<long long>(plain_sq_sum),
+					static_cast<long long>(dsp_sum), static_cast<long long>(dsp_sq_sum));
+			return false;
+		}
+	}
+	return true;
+}
+
+template<size_t SIZE>
+bool window_matches(uint32_t pushes){
+	Lcg lcg;
+	static algo::stages::GradientWindow<SIZE, algo::utils::fixed_math> window;
+	static etl::array<int32_t, SIZE> last;
+	window.reset();
+	for (uint32_t i{0}; i < pushes; i++){
+		const int32_t value = lcg.gradient();
+		window.push(value);
+		last[i % SIZE] = value;
+		if (i + 1 < SIZE) continue;
+
+		const int32_t expected = algo::utils::standard_deviation(algo::utils::fixed_math{}, last);
+		if (window.std_dev() != expected){
+			fprintf(stderr, "window %zu, push %u: std-dev %d, recomputed %d\n", SIZE, i, window.std_dev(), expected);
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+int main(void){
+	const bool ok = kernel_matches(4000000) && window_matches<7>(100000) && window_matches<600>(100000) &&
+			window_matches<3200>(50000);
+	if (!ok) return 1;
+	printf("packed gradient sums match the plain ones\n");
+	return 0;
+}
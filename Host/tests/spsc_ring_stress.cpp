@@ -0,0 +1,139 @@
+/*
+ * spsc_ring_stress.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Hammers SpscRing from a producer and a consumer thread. The producer pushes
+ *  a sequence number and its complement and never retries, so a full ring drops
+ *  items. After both threads join every sequence number must have been either
+ *  received exactly once, in order and untorn, or dropped by a failed push(),
+ *  and the failed pushes must match overruns(). The consumer alternates between
+ *  pop() and peek()/drop() runs, the two ways firmware drains the ring.
+ *  Exits non-zero on the first failed check.
+ *
+ *  usage: spsc_ring_stress [--items N]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.hpp"
+
+namespace {
+
+struct Item{
+	uint32_t seq;
+	uint32_t check;
+};
+
+static const constexpr size_t RING_SIZE = 61;
+
+struct Result{
+	std::vector<bool> dropped;
+	std::vector<bool> received;
+	uint32_t failed_pushes{0};
+	uint32_t errors{0};
+	std::atomic<bool> produced{false};
+};
+
+void produce(SpscRing<Item, RING_SIZE>& ring, uint32_t items, Result& result){
+	for (uint32_t seq{0}; seq < items; seq++){
+		if (!ring.push({seq, ~seq})){
+			result.dropped[seq] = true;
+			result.failed_pushes++;
+			// let the consumer drain, also on a single core
+			std::this_thread::yield();
+		}
+	}
+	result.produced.store(true, std::memory_order_release);
+}
+
+bool accept(const Item& item, uint32_t& next, Result& result){
+	if (item.check != ~item.seq){
+		fprintf(stderr, "torn item %u (check %08x)\n", item.seq, item.check);
+		return false;
+	}
+	if (item.seq < next){
+		fprintf(stderr, "item %u out of order or duplicated, expected >= %u\n", item.seq, next);
+		return false;
+	}
+	result.received[item.seq] = true;
+	next = item.seq + 1;
+	return true;
+}
+
+void consume(SpscRing<Item, RING_SIZE>& ring, Result& result){
+	uint32_t next{0};
+	uint32_t round{0};
+	while (result.errors == 0){
+		// read before draining, so an empty ring after the drain is final
+		const bool produced = result.produced.load(std::memory_order_acquire);
+		if (round++ & 1){
+			const SpscSegments<Item> segments = ring.peek();
+			for (size_t i{0}; i < segments.first_size; i++)
+				if (!accept(segments.first[i], next, result)) result.errors++;
+			for (size_t i{0}; i < segments.second_size; i++)
+				if (!accept(segments.second[i], next, result)) result.errors++;
+			ring.drop(segments.size());
+		} else {
+			Item item;
+			for (size_t i{0}; i < RING_SIZE / 2 && ring.pop(item); i++)
+				if (!accept(item, next, result)) result.errors++;
+		}
+		if (ring.empty()){
+			if (produced) break;
+			std::this_thread::yield();
+		}
+	}
+}
+
+}
+
+int main(int argc, char** argv){
+	uint32_t items{5000000};
+	for (int i{1}; i < argc; i++){
+		if (!strcmp(argv[i], "--items") && i + 1 < argc) items = strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr, "usage: %s [--items N]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (items == 0) return 2;
+
+	static SpscRing<Item, RING_SIZE> ring;
+	Result result;
+	result.dropped.assign(items, false);
+	result.received.assign(items, false);
+
+	std::thread consumer{consume, std::ref(ring), std::ref(result)};
+	std::thread producer{produce, std::ref(ring), items, std::ref(result)};
+	producer.join();
+	consumer.join();
+
+	if (result.errors) return 1;
+	if (!ring.empty()){
+		fprintf(stderr, "%zu items left in the ring\n", ring.size());
+		return 1;
+	}
+	uint32_t received{0};
+	for (uint32_t seq{0}; seq < items; seq++){
+		if (result.dropped[seq] == result.received[seq]){
+			fprintf(stderr, "item %u %s\n", seq, result.dropped[seq] ? "both dropped and received" : "lost");
+			return 1;
+		}
+		received += result.received[seq];
+	}
+	if (result.failed_pushes != ring.overruns()){
+		fprintf(stderr, "overruns() %u, failed pushes %u\n", ring.overruns(), result.failed_pushes);
+		return 1;
+	}
+
+	printf("%u items, %u received, %u overruns\n", items, received, ring.overruns());
+	return 0;
+}
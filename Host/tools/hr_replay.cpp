@@ -0,0 +1,121 @@
+/*
+ * hr_replay.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Replays recorded PPG csv (scripts/test_data.csv, scripts/ppg.csv) through
+ *  SlidingHeartRate at full CPU speed, with the same window and hop as
+ *  Max30102_Task, and prints HR per hop.
+ *
+ *  usage: hr_replay <file.csv> [--loops N] [--sps N] [--windowed | --stream] [--quiet] [--profile]
+ *
+ *  csv with "time" column (seconds) uses recorded timestamps, csv with only
+ *  IR,RED gets timestamps generated from --sps (default MAX30102_SAMPLES_PER_SECOND).
+ *  --loops replays the recording N times back to back with continuous time.
+ *  --windowed recomputes batch HeartRate over the whole window every hop instead,
+ *  --stream uses StreamingHeartRate.
+ *  --profile prints profiler sites (ns) to stderr at the end.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "ox_data_structure.hpp"
+#include "hr_pipeline.hpp"
+#include "ppg_csv.hpp"
+#include "profiler.hpp"
+
+namespace {
+
+struct Options {
+	const char* path{nullptr};
+	uint32_t loops{1};
+	uint32_t sps{MAX30102_SAMPLES_PER_SECOND};
+	bool stream{false};
+	bool windowed{false};
+	bool quiet{false};
+	bool profile{false};
+};
+
+bool parse_options(int argc, char** argv, Options& opt){
+	for (int i{1}; i < argc; i++){
+		if (!strcmp(argv[i], "--loops") && i + 1 < argc) opt.loops = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--sps") && i + 1 < argc) opt.sps = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--stream")) opt.stream = true;
+		else if (!strcmp(argv[i], "--windowed")) opt.windowed = true;
+		else if (!strcmp(argv[i], "--quiet")) opt.quiet = true;
+		else if (!strcmp(argv[i], "--profile")) opt.profile = true;
+		else if (argv[i][0] != '-' && opt.path == nullptr) opt.path = argv[i];
+		else return false;
+	}
+	return opt.path != nullptr && opt.loops > 0 && opt.sps > 0 && !(opt.stream && opt.windowed);
+}
+
+using WindowedReplay = WindowedHr<MAX30102_SAMPLES_PER_SECOND>;
+using SlidingReplay = SlidingHr<MAX30102_SAMPLES_PER_SECOND>;
+using StreamReplay = StreamingHr<MAX30102_SAMPLES_PER_SECOND>;
+
+template<typename Replay>
+int run(const Options& opt, const PpgRecording& rec){
+	static Replay replay{};
+	uint64_t samples{0};
+	uint32_t windows{0}, valid{0};
+	uint64_t hr_sum{0};
+
+	if (!opt.quiet) printf("ts_ms,hr\n");
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t loop{0}; loop < opt.loops; loop++){
+		const int32_t offset = static_cast<int32_t>(loop) * rec.duration_ms;
+		for (const auto& s : rec.samples){
+			const TimestampedOxSample sample{s.ts + offset, s.ir, s.red};
+			if (replay.push(sample)){
+				const uint32_t hr = replay.get_hr();
+				if (!opt.quiet) printf("%d,%u\n", sample.ts, hr);
+				// 0 means not enough peaks in window, keep it out of the mean
+				if (hr != 0){
+					hr_sum += hr;
+					valid++;
+				}
+				windows++;
+			}
+			samples++;
+		}
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const double recorded_s = (static_cast<double>(rec.duration_ms) * opt.loops) / 1000.0;
+
+	fprintf(stderr, "%s: %llu samples, %u HR updates (%u non-zero), mean HR %.1f bpm\n",
+			opt.stream ? "stream" : (opt.windowed ? "windowed" : "sliding"),
+			static_cast<unsigned long long>(samples), windows, valid,
+			valid ? static_cast<double>(hr_sum) / valid : 0.0);
+	fprintf(stderr, "%.6f s wall, %.0f samples/s, %.0fx real time (%.1f s recorded)",
+			seconds, samples / seconds, recorded_s / seconds, recorded_s);
+	if (replay.overruns()) fprintf(stderr, ", %u ring overruns", replay.overruns());
+	fprintf(stderr, "\n");
+	if (opt.profile) profiler::dump(stderr);
+	return 0;
+}
+
+}
+
+int main(int argc, char** argv){
+	Options opt{};
+	if (!parse_options(argc, argv, opt)){
+		fprintf(stderr, "usage: %s <file.csv> [--loops N] [--sps N] [--windowed | --stream] [--quiet] [--profile]\n", argv[0]);
+		return 2;
+	}
+
+	static PpgRecording rec{};
+	if (!load_ppg_csv(opt.path, opt.sps, rec)){
+		fprintf(stderr, "no samples in %s\n", opt.path);
+		return 1;
+	}
+
+	if (opt.stream) return run<StreamReplay>(opt, rec);
+	return opt.windowed ? run<WindowedReplay>(opt, rec) : run<SlidingReplay>(opt, rec);
+}
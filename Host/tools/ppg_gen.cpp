@@ -0,0 +1,51 @@
+/*
+ * ppg_gen.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: maskopol
+ *
+ *  Writes synthetic PPG as "time,IR,RED" csv (time in seconds), the layout of
+ *  scripts/test_data.csv, so hr_replay, max30102_sim --csv and the notebooks
+ *  can use it. True heart rate goes to stderr once per second.
+ *
+ *  usage: ppg_gen [--scenario rest|exercise|motion] [--sps N] [--seconds N] [--seed N] > out.csv
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ppg_synth.hpp"
+
+int main(int argc, char** argv){
+	const char* scenario{"rest"};
+	uint32_t sps{MAX30102_SAMPLES_PER_SECOND}, seconds{60};
+	uint64_t seed{1};
+
+	for (int i{1}; i < argc; i++){
+		if (!strcmp(argv[i], "--scenario") && i + 1 < argc) scenario = argv[++i];
+		else if (!strcmp(argv[i], "--sps") && i + 1 < argc) sps = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+		else sps = 0;
+	}
+
+	PpgSynthConfig cfg{};
+	if (sps == 0 || !PpgSynth::preset(scenario, cfg)){
+		fprintf(stderr, "usage: %s [--scenario rest|exercise|motion] [--sps N] [--seconds N] [--seed N]\n", argv[0]);
+		return 2;
+	}
+	cfg.sample_rate = sps;
+	cfg.seed = seed;
+
+	PpgSynth synth{cfg};
+	printf("time,IR,RED\n");
+	for (uint64_t i{0}; i < static_cast<uint64_t>(seconds) * sps; i++){
+		const auto s = synth.next();
+		// sample time exactly, ms timestamps of TimestampedOxSample lose it above 1000 sps
+		printf("%.6f,%d.0,%d.0\n", static_cast<double>(i) / sps, s.sample.ir, s.sample.red);
+		if (i % sps == 0) fprintf(stderr, "%llu s: %.1f bpm%s\n", static_cast<unsigned long long>(i / sps), s.true_bpm, s.motion ? " (motion)" : "");
+	}
+	return 0;
+}
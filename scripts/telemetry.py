@@ -0,0 +1,209 @@
+"""Decoder for the framed binary telemetry stream (Core/Inc/telemetry.hpp).
+
+Frames are COBS encoded and end with 0x00, payload is
+type u8 | seq u16 | body | crc16 u16 (CRC-16/CCITT-FALSE), little endian.
+Corrupted frames are counted and skipped, gaps in the per type sequence
+number are counted as lost frames.
+
+Library use:
+
+    decoder = TelemetryDecoder()
+    for message in decoder.feed(chunk):
+        ...
+
+Command line - capture file (USART1 or ITM port 2 payload, firmware_posix --telemetry)
+or a serial port, raw samples go to a "time,IR,RED" csv that hr_replay,
+max30102_sim --csv and the notebooks read:
+
+    python3 telemetry.py capture.bin --samples samples.csv --hr hr.csv
+    python3 telemetry.py --port /dev/ttyUSB0 --baud 921600 --samples samples.csv
+    python3 telemetry.py --port /dev/pts/3 --hr hr.csv
+
+Without pyserial the port is opened raw and --baud is left as configured.
+"""
+import argparse
+import struct
+import sys
+from collections import namedtuple
+from typing import Dict, Iterator, Optional
+
+SAMPLES = 0x01
+HEART_RATE = 0x02
+DIAGNOSTICS = 0x03
+
+Sample = namedtuple('Sample', 'ts_ms ir red')
+Samples = namedtuple('Samples', 'seq samples')
+HeartRate = namedtuple('HeartRate', 'seq ts_ms bpm finger_on valid')
+Diagnostics = namedtuple('Diagnostics', 'seq ts_ms ring_overruns log_dropped trace_dropped telemetry_dropped')
+
+
+def crc16(data: bytes) -> int:
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(frame: bytes) -> Optional[bytes]:
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame):
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_payload(payload: bytes):
+    kind, seq = payload[0], struct.unpack_from('<H', payload, 1)[0]
+    body = payload[3:-2]
+    if kind == SAMPLES:
+        ts, count = struct.unpack_from('<IB', body, 0)
+        if len(body) != 5 + 7 * count:
+            return None
+        samples = []
+        for i in range(count):
+            offset = 5 + 7 * i
+            dt = body[offset]
+            ir = int.from_bytes(body[offset + 1:offset + 4], 'little')
+            red = int.from_bytes(body[offset + 4:offset + 7], 'little')
+            ts += dt
+            samples.append(Sample(ts, ir, red))
+        return Samples(seq, samples)
+    if kind == HEART_RATE and len(body) == 7:
+        ts, bpm_x10, flags = struct.unpack('<IHB', body)
+        return HeartRate(seq, ts, bpm_x10 / 10.0, bool(flags & 1), bool(flags & 2))
+    if kind == DIAGNOSTICS and len(body) == 20:
+        return Diagnostics(seq, *struct.unpack('<5I', body))
+    return None
+
+
+class TelemetryDecoder:
+    def __init__(self):
+        self.__buffer = bytearray()
+        self.__last_seq: Dict[int, int] = {}
+        self.frames = 0
+        self.corrupted = 0
+        self.lost: Dict[int, int] = {SAMPLES: 0, HEART_RATE: 0, DIAGNOSTICS: 0}
+
+    def feed(self, data: bytes) -> Iterator:
+        self.__buffer += data
+        while True:
+            end = self.__buffer.find(0)
+            if end < 0:
+                return
+            frame = bytes(self.__buffer[:end])
+            del self.__buffer[:end + 1]
+            if not frame:
+                continue
+            message = self.__decode(frame)
+            if message is not None:
+                yield message
+
+    def __decode(self, frame: bytes):
+        payload = cobs_decode(frame)
+        if payload is None or len(payload) < 5 or crc16(payload[:-2]) != struct.unpack_from('<H', payload, len(payload) - 2)[0]:
+            self.corrupted += 1
+            return None
+        message = parse_payload(payload)
+        if message is None:
+            self.corrupted += 1
+            return None
+        self.frames += 1
+        kind = payload[0]
+        if kind in self.__last_seq:
+            self.lost[kind] += (message.seq - self.__last_seq[kind] - 1) & 0xFFFF
+        self.__last_seq[kind] = message.seq
+        return message
+
+
+def tty_chunks(path: str) -> Iterator[bytes]:
+    """Raw read of a pty (firmware_posix --telemetry-pty) or serial port without pyserial."""
+    import os
+    import termios
+    import tty
+    fd = os.open(path, os.O_RDONLY | os.O_NOCTTY)
+    try:
+        tty.setraw(fd, termios.TCSANOW)
+        while True:
+            try:
+                chunk = os.read(fd, 4096)
+            except OSError:
+                # EIO once the pty master is closed, firmware_posix exited
+                return
+            if not chunk:
+                return
+            yield chunk
+    finally:
+        os.close(fd)
+
+
+def chunks(args) -> Iterator[bytes]:
+    if args.port:
+        try:
+            import serial
+        except ImportError:
+            yield from tty_chunks(args.port)
+            return
+        with serial.Serial(args.port, baudrate=args.baud, timeout=1) as port:
+            while True:
+                yield port.read(4096)
+    stream = sys.stdin.buffer if args.capture == '-' else open(args.capture, 'rb')
+    while True:
+        chunk = stream.read(65536)
+        if not chunk:
+            return
+        yield chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', nargs='?', default='-', help='binary capture file, - for stdin')
+    parser.add_argument('--port', help='read from a serial port or pty instead of a file')
+    parser.add_argument('--baud', type=int, default=921600)
+    parser.add_argument('--samples', help='write raw samples as time,IR,RED csv')
+    parser.add_argument('--hr', help='write HR results as ts_ms,bpm,finger_on csv')
+    args = parser.parse_args()
+
+    samples_csv = open(args.samples, 'w') if args.samples else None
+    hr_csv = open(args.hr, 'w') if args.hr else None
+    if samples_csv:
+        samples_csv.write('time,IR,RED\n')
+    if hr_csv:
+        hr_csv.write('ts_ms,hr,finger_on\n')
+
+    decoder = TelemetryDecoder()
+    sample_count = 0
+    try:
+        for chunk in chunks(args):
+            for message in decoder.feed(chunk):
+                if isinstance(message, Samples):
+                    sample_count += len(message.samples)
+                    if samples_csv:
+                        for s in message.samples:
+                            samples_csv.write('{:.3f},{}.0,{}.0\n'.format(s.ts_ms / 1000.0, s.ir, s.red))
+                elif isinstance(message, HeartRate):
+                    if hr_csv:
+                        hr_csv.write('{},{:.1f},{}\n'.format(message.ts_ms, message.bpm, int(message.finger_on)))
+                    else:
+                        print('{:10d} ms  hr {:5.1f} bpm{}'.format(message.ts_ms, message.bpm, '' if message.finger_on else '  (no finger)'))
+                elif isinstance(message, Diagnostics):
+                    print('{:10d} ms  diagnostics: {} ring overruns, dropped {} log, {} trace, {} telemetry'.format(
+                        message.ts_ms, message.ring_overruns, message.log_dropped, message.trace_dropped, message.telemetry_dropped))
+    except KeyboardInterrupt:
+        pass
+
+    print('{} frames, {} samples, {} corrupted, lost samples/hr/diagnostics frames: {}/{}/{}'.format(
+        decoder.frames, sample_count, decoder.corrupted,
+        decoder.lost[SAMPLES], decoder.lost[HEART_RATE], decoder.lost[DIAGNOSTICS]), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,127 @@
+"""Decoder for binary TRACE records (Core/Inc/trace.hpp).
+
+Format strings live only in the ELF (trace_fmt section), records carry their
+offset, a timestamp and raw 32 bit arguments. Usage:
+
+    python3 trace_decoder.py Debug/SmartVape.elf itm_port1.bin --clock-hz 84e6
+    python3 trace_decoder.py build-host/firmware_posix trace.bin --clock-hz 1e9
+
+The input is the raw ITM stimulus port 1 payload (or --trace output of
+firmware_posix), little endian words from the first record on.
+"""
+import argparse
+import re
+import struct
+import sys
+from typing import Dict, Iterator, Tuple
+
+ARGS_BITS = 4
+TRACE_SECTION = 'trace_fmt'
+
+# printf conversion, length modifiers are dropped for python % formatting
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diouxXcfFeEgGp%])')
+
+
+def read_trace_section(elf_path: str) -> bytes:
+    with open(elf_path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF':
+        raise ValueError('{} is not an ELF file'.format(elf_path))
+    is_64 = elf[4] == 2
+    endian = '<' if elf[5] == 1 else '>'
+
+    if is_64:
+        shoff, = struct.unpack_from(endian + 'Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x3A)
+        section = endian + 'IIQQQQIIQQ'
+    else:
+        shoff, = struct.unpack_from(endian + 'I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x2E)
+        section = endian + 'IIIIIIIIII'
+
+    headers = [struct.unpack_from(section, elf, shoff + i * shentsize) for i in range(shnum)]
+    names_offset = headers[shstrndx][4]
+    for header in headers:
+        name_offset, offset, size = header[0], header[4], header[5]
+        end = elf.index(b'\0', names_offset + name_offset)
+        if elf[names_offset + name_offset:end].decode() == TRACE_SECTION:
+            return elf[offset:offset + size]
+    raise ValueError('{} has no {} section, built without TRACE?'.format(elf_path, TRACE_SECTION))
+
+
+def format_string(section: bytes, offset: int) -> str:
+    end = section.index(b'\0', offset)
+    return section[offset:end].decode('utf-8', errors='replace')
+
+
+def convert(spec: str, word: int):
+    if spec in 'di':
+        return struct.unpack('<i', struct.pack('<I', word))[0]
+    if spec in 'fFeEgG':
+        return struct.unpack('<f', struct.pack('<I', word))[0]
+    if spec == 'c':
+        return chr(word & 0xFF)
+    return word
+
+
+def render(fmt: str, args: Tuple[int, ...]) -> str:
+    values = []
+    specs = [m for m in CONVERSION.finditer(fmt) if m.group(3) != '%']
+    for match, word in zip(specs, args):
+        values.append(convert(match.group(3), word))
+
+    def python_spec(match):
+        flags, _, spec = match.groups()
+        if spec == 'p':
+            return '0x%08x'
+        return '%' + flags + spec
+    return CONVERSION.sub(python_spec, fmt) % tuple(values)
+
+
+def records(stream: bytes) -> Iterator[Tuple[int, int, Tuple[int, ...]]]:
+    words = struct.unpack('<{}I'.format(len(stream) // 4), stream[:len(stream) // 4 * 4])
+    i = 0
+    while i + 2 <= len(words):
+        header, timestamp = words[i], words[i + 1]
+        argc = header & ((1 << ARGS_BITS) - 1)
+        if i + 2 + argc > len(words):
+            break
+        yield header >> ARGS_BITS, timestamp, words[i + 2:i + 2 + argc]
+        i += 2 + argc
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('elf', help='firmware ELF the records come from')
+    parser.add_argument('trace', help='binary trace capture, - for stdin')
+    parser.add_argument('--clock-hz', type=float, default=84e6, help='timestamp clock, DWT runs at SystemCoreClock')
+    args = parser.parse_args()
+
+    section = read_trace_section(args.elf)
+    stream = sys.stdin.buffer.read() if args.trace == '-' else open(args.trace, 'rb').read()
+
+    cache: Dict[int, str] = {}
+    first = None
+    elapsed = 0
+    for offset, timestamp, words in records(stream):
+        if offset not in cache:
+            cache[offset] = format_string(section, offset) if offset < len(section) else None
+        fmt = cache[offset]
+        # 32 bit counter wraps, accumulate differences instead of using it raw
+        if first is None:
+            first = timestamp
+        elapsed += (timestamp - first) & 0xFFFFFFFF
+        first = timestamp
+        time_s = elapsed / args.clock_hz
+        if fmt is None:
+            print('{:12.6f} <unknown format offset 0x{:x}> {}'.format(time_s, offset, ' '.join(hex(w) for w in words)))
+            continue
+        try:
+            text = render(fmt, words)
+        except (TypeError, ValueError):
+            text = '{} <bad arguments {}>'.format(fmt, list(words))
+        print('{:12.6f} {}'.format(time_s, text))
+
+
+if __name__ == '__main__':
+    main()